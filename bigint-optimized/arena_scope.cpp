@@ -0,0 +1,55 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include "arena_scope.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+const size_t arena_scope::DEFAULT_CHUNK;
+
+static const size_t ARENA_ALIGNMENT = alignof(std::max_align_t);
+
+arena_scope::arena_scope(size_t chunk_bytes)
+        : previous(limb_allocator::set_thread_local(this)), cur(nullptr), end(nullptr),
+          chunk_bytes(chunk_bytes), used(0), live(0) {}
+
+arena_scope::~arena_scope() {
+    assert(live == 0 && "a value allocated in the arena outlives it, use escape()");
+    limb_allocator::set_thread_local(previous);
+    for (char* chunk : chunks) {
+        ::operator delete(chunk);
+    }
+}
+
+void* arena_scope::allocate(size_t& bytes) {
+    bytes = (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    if (static_cast<size_t>(end - cur) < bytes) {
+        size_t size = std::max(chunk_bytes, bytes);
+        chunks.push_back(static_cast<char*>(::operator new(size)));
+        cur = chunks.back();
+        end = cur + size;
+    }
+    void* res = cur;
+    cur += bytes;
+    used += bytes;
+    live++;
+    return res;
+}
+
+void arena_scope::deallocate(void*, size_t) {
+    live--;
+}
+
+big_integer arena_scope::escape(big_integer const& value) const {
+    limb_allocator* arena = limb_allocator::set_thread_local(previous);
+    big_integer res = value;
+    res.mas.detach();
+    limb_allocator::set_thread_local(arena);
+    return res;
+}
+
+size_t arena_scope::bytes_used() const {
+    return used;
+}
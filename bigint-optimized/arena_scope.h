@@ -0,0 +1,39 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_ARENA_SCOPE_H
+#define BIGINT_ARENA_SCOPE_H
+
+#include "big_integer.h"
+#include "limb_allocator.h"
+#include <cstddef>
+#include <vector>
+
+// While alive, every heap buffer created by this thread is bump-allocated
+// from the arena and all of them are dropped at once when the scope ends.
+// Values that must outlive the scope have to be copied out with escape().
+struct arena_scope : limb_allocator {
+    explicit arena_scope(size_t chunk_bytes = DEFAULT_CHUNK);
+    ~arena_scope() override;
+    arena_scope(arena_scope const& other) = delete;
+    arena_scope& operator=(arena_scope const& other) = delete;
+
+    void* allocate(size_t& bytes) override;
+    void deallocate(void* ptr, size_t bytes) override;
+
+    big_integer escape(big_integer const& value) const;
+    size_t bytes_used() const;
+
+    static const size_t DEFAULT_CHUNK = size_t(1) << 16u;
+private:
+    limb_allocator* previous;
+    std::vector<char*> chunks;
+    char* cur;
+    char* end;
+    size_t chunk_bytes;
+    size_t used;
+    size_t live;
+};
+
+#endif //BIGINT_ARENA_SCOPE_H
@@ -1,37 +1,71 @@
 #include "big_integer.h"
+#include "limb_kernels.h"
+#include "power_cache.h"
+#include <cstring>
+#include <istream>
+#include <ostream>
 
 static uint32_t MAX_DIGIT = UINT32_MAX;
+static const size_t DECIMAL_BLOCK_DIGITS = 9;
+static const uint32_t DECIMAL_BLOCK_BASE = 1000000000;
+static const uint32_t POWERS_OF_TEN[DECIMAL_BLOCK_DIGITS + 1] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                                                 10000000, 100000000, 1000000000};
+static const size_t DECIMAL_SPLIT_THRESHOLD = 64;
 
-big_integer::big_integer() : mas(), sign(true) {}
+big_integer::big_integer() : mas() {}
 
 big_integer::~big_integer() = default;
 
 big_integer::big_integer(int a) {
-    sign = true;
-    if (a == 0) {
-        return;
+    set_word(a);
+}
+
+uint32_t big_integer::get_end_of_mas() const {
+    return (sign() ? 0 : MAX_DIGIT);
+}
+
+// limbs above this are copies of the sign extension. Kernels leave such
+// limbs in place and only the observers below look past them, so loops of
+// += never shrink a number just to grow it again on the next step
+size_t big_integer::significant_size() const {
+    uint32_t end = get_end_of_mas();
+    uint32_t const* limbs = mas.limbs();
+    size_t n = mas.size();
+    while (n > 0 && limbs[n - 1] == end) {
+        n--;
     }
-    sign = (a > 0);
-    int64_t x = a;
-    if (x < 0) {
-        mas.push_back(static_cast<uint32_t>(x));
-    } else {
-        mas.push_back(x);
+    return n;
+}
+
+// values fitting int64_t live in at most two limbs and skip the limb loops
+bool big_integer::is_word() const {
+    size_t n = mas.size();
+    if (n > 2) {
+        n = significant_size();
     }
-    shrink_to_fit();
+    return n < 2 || (n == 2 && (mas[1] >> 31u) != static_cast<uint32_t>(sign()));
 }
 
-uint32_t big_integer::get_end_of_mas() const {
-    return (sign ? 0 : MAX_DIGIT);
+int64_t big_integer::word() const {
+    uint64_t lo = (mas.size() > 0 ? mas[0] : get_end_of_mas());
+    uint64_t hi = (mas.size() > 1 ? mas[1] : get_end_of_mas());
+    return static_cast<int64_t>(lo | (hi << 32u));
 }
 
-big_integer& big_integer::shrink_to_fit() {
-    uint32_t to_delete = get_end_of_mas();
-    size_t nw_size = mas.size();
-    while (nw_size > 0 && mas[nw_size - 1] == to_delete) {
-        nw_size--;
+big_integer& big_integer::set_word(int64_t value) {
+    set_sign(value >= 0);
+    uint64_t word = static_cast<uint64_t>(value);
+    uint32_t end = get_end_of_mas();
+    size_t count = 2;
+    if (static_cast<uint32_t>(word >> 32u) == end) {
+        count = (static_cast<uint32_t>(word) == end ? 0 : 1);
     }
-    mas.resize(nw_size);
+    mas.assign_word(word, count);
+    return *this;
+}
+
+big_integer& big_integer::shrink_to_fit() {
+    mas.resize(significant_size());
     return *this;
 }
 
@@ -43,23 +77,40 @@ void big_integer::fill(size_t size) {
     mas.resize(cur_size + new_elements_count, to_fill);
 }
 
-big_integer::big_integer(const big_integer& other) : mas(other.mas), sign(other.sign) {}
+big_integer::big_integer(const big_integer& other) : mas(other.mas) {}
+
+// the sign travels with the storage header, and a moved-from storage is an
+// empty non-negative one, i.e. zero
+big_integer::big_integer(big_integer&& other) noexcept : mas(std::move(other.mas)) {}
 
 big_integer& big_integer::operator=(const big_integer& other) {
-    big_integer copy = other;
-    mas = copy.mas;
-    sign = copy.sign;
+    mas = other.mas;
     return *this;
 }
 
-big_integer& big_integer::negate() {
-    big_integer x = *this;
-    x = ~x + 1;
-    mas = x.mas;
-    sign = x.sign;
+big_integer& big_integer::operator=(big_integer&& other) noexcept {
+    if (this != &other) {
+        mas = std::move(other.mas);
+    }
     return *this;
 }
 
+void swap(big_integer& a, big_integer& b) {
+    std::swap(a.mas, b.mas);
+}
+
+bool big_integer::sign() const {
+    return !mas.tag();
+}
+
+void big_integer::set_sign(bool value) {
+    mas.set_tag(!value);
+}
+
+big_integer& big_integer::negate() {
+    return *this = ~*this + 1;
+}
+
 big_integer::big_integer(std::string const& str) : big_integer() {
     if (str.empty()) {
         throw std::invalid_argument("empty string found");
@@ -72,41 +123,91 @@ big_integer::big_integer(std::string const& str) : big_integer() {
             throw std::invalid_argument("string contains non-digit chars");
         }
     }
-    int loop_beg = (str[0] == '-'  || str[0] == '+' ? 1 : 0);
-    uint32_t ten = 10;
-    big_integer cur;
+    size_t loop_beg = (str[0] == '-'  || str[0] == '+' ? 1 : 0);
+    std::vector<uint32_t> blocks;
+    uint32_t block = 0;
+    size_t block_len = 0;
     for (size_t i = loop_beg; i != str.size(); i++) {
-        mul(ten);
-        cur = static_cast<int>(str[i] - '0');
-        *this += cur;
+        block = block * 10 + static_cast<uint32_t>(str[i] - '0');
+        if (++block_len == DECIMAL_BLOCK_DIGITS) {
+            blocks.push_back(block);
+            block = 0;
+            block_len = 0;
+        }
     }
+    *this = from_decimal_digits(blocks, block, block_len);
     if (loop_beg == 1 && str[0] == '-') {
         negate();
     }
 }
 
-std::string to_string(const big_integer& a) {
-    std::string res;
-    big_integer x = a.abs();
-    uint32_t ten = 10;
-    int digit;
-    while (x.mas.size() != 0) {
-        big_integer cur = x % ten;
-        if (cur.mas.size() == 0) {
-            digit = 0;
-        } else {
-            digit = cur.mas[0];
+// a non-negative value from its little-endian limbs
+big_integer big_integer::from_limbs(uint32_t const* limbs, size_t count) {
+    big_integer res;
+    res.mas.resize(count);
+    std::copy(limbs, limbs + count, res.mas.prepare_write(count));
+    return res;
+}
+
+big_integer big_integer::from_decimal_blocks(uint32_t const* blocks, size_t count) {
+    big_integer res;
+    res.mas.reserve(count * 15 / 16 + 1);
+    if (count <= DECIMAL_SPLIT_THRESHOLD) {
+        for (size_t i = count; i >= 1; i--) {
+            res.mul_add(DECIMAL_BLOCK_BASE, blocks[i - 1]);
         }
-        res.push_back('0' + digit);
-        x = x.div(ten);
+        return res;
+    }
+    size_t k = 0;
+    while ((size_t(2) << k) < count) {
+        k++;
     }
-    if (res.empty()) {
-        res = "0";
+    size_t half = (size_t(1) << k);
+    res = from_decimal_blocks(blocks + half, count - half);
+    res *= power_cache::power(DECIMAL_BLOCK_BASE, k);
+    res += from_decimal_blocks(blocks, half);
+    return res;
+}
+
+big_integer big_integer::from_decimal_digits(std::vector<uint32_t>& blocks, uint32_t tail, size_t tail_len) {
+    std::reverse(blocks.begin(), blocks.end());
+    big_integer res = from_decimal_blocks(blocks.data(), blocks.size());
+    return res.mul_add(POWERS_OF_TEN[tail_len], tail);
+}
+
+std::vector<uint32_t> big_integer::decimal_blocks() const {
+    std::vector<uint32_t> blocks;
+    big_integer x = abs();
+    blocks.reserve(x.mas.size() * 16 / 15 + 1);
+    while (x.mas.size() != 0) {
+        blocks.push_back(x.div_rem(DECIMAL_BLOCK_BASE));
+    }
+    return blocks;
+}
+
+static size_t write_block(char* out, uint32_t block, bool pad) {
+    char digits[DECIMAL_BLOCK_DIGITS];
+    size_t len = 0;
+    do {
+        digits[len++] = static_cast<char>('0' + block % 10);
+        block /= 10;
+    } while (block != 0);
+    size_t width = (pad ? DECIMAL_BLOCK_DIGITS : len);
+    std::fill(out, out + width - len, '0');
+    std::reverse_copy(digits, digits + len, out + width - len);
+    return width;
+}
+
+std::string to_string(const big_integer& a) {
+    std::vector<uint32_t> blocks = a.decimal_blocks();
+    if (blocks.empty()) {
+        return "0";
     }
-    if (!a.sign) {
-        res.push_back('-');
+    std::string res(a.sign() ? "" : "-");
+    char buf[DECIMAL_BLOCK_DIGITS];
+    for (size_t i = blocks.size(); i >= 1; i--) {
+        res.append(buf, write_block(buf, blocks[i - 1], i != blocks.size()));
     }
-    std::reverse(res.begin(), res.end());
     return res;
 }
 
@@ -116,35 +217,51 @@ big_integer big_integer::operator+() const {
 }
 
 big_integer& big_integer::operator+=(const big_integer& rhs) {
-    size_t sz = std::max(rhs.mas.size(), mas.size()) + 1;
+    int64_t res_word;
+    if (is_word() && rhs.is_word() && !__builtin_add_overflow(word(), rhs.word(), &res_word)) {
+        return set_word(res_word);
+    }
+    size_t sz = std::max(rhs.mas.size(), mas.size());
+    uint64_t ends = static_cast<uint64_t>(get_end_of_mas()) + rhs.get_end_of_mas();
+    uint32_t rhs_end = rhs.get_end_of_mas();
     fill(sz);
-    uint64_t rem = 0;
-    for (size_t i = 0; i < sz; i++) {
-         uint64_t cur = rem + (*this)[i] + rhs[i];
-        mas[i] = static_cast<uint32_t>(cur);
+    uint32_t* res = mas.prepare_write(sz);
+    size_t m = rhs.mas.size();
+    uint64_t rem = add_n(res, res, rhs.mas.limbs(), m);
+    for (size_t i = m; i < sz; i++) {
+        uint64_t cur = rem + res[i] + rhs_end;
+        res[i] = static_cast<uint32_t>(cur);
         rem = (cur >> 32u);
     }
-    sign = !(mas.back() >> 31u);
-    return shrink_to_fit();
+    uint64_t top = ends + rem;
+    // every limb above the top one is the same sign extension
+    set_sign(static_cast<uint32_t>(ends + (top >> 32u)) == 0);
+    if (static_cast<uint32_t>(top) != get_end_of_mas()) {
+        mas.push_back(static_cast<uint32_t>(top));
+    }
+    return *this;
 }
 
 big_integer& big_integer::operator-=(const big_integer& rhs) {
+    int64_t res_word;
+    if (is_word() && rhs.is_word() && !__builtin_sub_overflow(word(), rhs.word(), &res_word)) {
+        return set_word(res_word);
+    }
     return ((*this) += (-rhs));
 }
 
 big_integer big_integer::operator~() const {
     big_integer res;
     res.mas = mas;
-    res.sign = !(sign);
-    for (size_t i = 0; i < mas.size(); i++) {
-        res.mas[i] = ~res.mas[i];
-    }
-    return res.shrink_to_fit();
+    res.set_sign(!sign());
+    uint32_t* res_mas = res.mas.prepare_write(mas.size());
+    bitwise_1<bit_xor>(res_mas, res_mas, MAX_DIGIT, mas.size());
+    return res;
 }
 
 big_integer big_integer::operator-() const {
-    if ((*this) == 0) {
-        return *this;
+    if (is_word() && word() != INT64_MIN) {
+        return big_integer().set_word(-word());
     }
     big_integer res = *this;
     res.negate();
@@ -182,7 +299,9 @@ big_integer operator-(big_integer a, const big_integer& b) {
 }
 
 bool operator==(const big_integer& a, const big_integer& b) {
-    return (a.sign == b.sign && a.mas == b.mas);
+    size_t n = a.significant_size();
+    return (a.sign() == b.sign() && n == b.significant_size()
+            && std::equal(a.mas.limbs(), a.mas.limbs() + n, b.mas.limbs()));
 }
 
 bool operator!=(const big_integer& a, const big_integer& b) {
@@ -194,13 +313,17 @@ bool operator>(const big_integer& a, const big_integer& b) {
 }
 
 bool operator<=(const big_integer& a, const big_integer& b) {
-    if (a.sign != b.sign) {
-        return (b.sign);
+    if (a.is_word() && b.is_word()) {
+        return a.word() <= b.word();
+    }
+    if (a.sign() != b.sign()) {
+        return (b.sign());
     }
-    if (a.mas.size() != b.mas.size()) {
-        return (a.mas.size() < b.mas.size());
+    size_t n = a.significant_size(), m = b.significant_size();
+    if (n != m) {
+        return ((n < m) == a.sign());
     }
-    for (size_t i = a.mas.size(); i >= 1; i--) {
+    for (size_t i = n; i >= 1; i--) {
         if (a.mas[i - 1] != b.mas[i - 1])
             return (a.mas[i - 1] <= b.mas[i - 1]);
     }
@@ -216,39 +339,196 @@ bool operator>=(const big_integer& a, const big_integer& b) {
 }
 
 big_integer& big_integer::mul(uint32_t rhs) {
-    uint64_t rem = 0;
-    uint64_t to_mul = rhs;
-    for (size_t i = 0; i < mas.size(); i++) {
-        uint64_t cur = static_cast<uint64_t>(mas[i]) * to_mul + rem;
-        mas[i] = static_cast<uint32_t>(cur);
-        rem = (cur >> 32u);
-    }
+    return mul_add(rhs, 0);
+}
+
+big_integer& big_integer::mul_add(uint32_t rhs, uint32_t add) {
+    uint32_t* res = mas.prepare_write(mas.size());
+    uint32_t rem = mul_1(res, res, mas.size(), rhs, add);
     if (rem != 0) {
         mas.push_back(rem);
     }
-    return shrink_to_fit();
+    return *this;
 }
 
-storage big_integer::multiply(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
-    size_t n = a.size(), m = b.size();
-    storage res;
-    res.resize(n + m);
+static size_t trimmed(uint32_t const* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+// dst[0, len) += src[0, count), the carry runs up to len and limbs of src
+// past len must be zero
+static void add_limbs(uint32_t* dst, size_t len, uint32_t const* src, size_t count) {
+    count = std::min(count, len);
+    uint32_t carry = add_n(dst, dst, src, count);
+    for (size_t i = count; i < len && carry != 0; i++) {
+        carry = (++dst[i] == 0);
+    }
+}
+
+// dst[0, len) -= src[0, count), dst must not become negative and limbs of
+// src past len must be zero
+static void sub_limbs(uint32_t* dst, size_t len, uint32_t const* src, size_t count) {
+    count = std::min(count, len);
+    uint32_t borrow = sub_n(dst, dst, src, count);
+    for (size_t i = count; i < len && borrow != 0; i++) {
+        borrow = (dst[i]-- == 0);
+    }
+}
+
+// res[0, n + m) = a * b, res must be zero on entry
+static void mul_limbs(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* res) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m < karatsuba_threshold()) {
+        mul_basecase(a, n, b, m, res);
+        return;
+    }
+    if (2 * m <= n) {
+        // unbalanced: m-limb slices of a times b
+        std::vector<uint32_t> part(2 * m);
+        for (size_t off = 0; off < n; off += m) {
+            size_t len = std::min(m, n - off);
+            std::fill(part.begin(), part.end(), 0);
+            mul_limbs(a + off, len, b, m, part.data());
+            add_limbs(res + off, n + m - off, part.data(), len + m);
+        }
+        return;
+    }
+    // Karatsuba: a = a1 B^h + a0, b = b1 B^h + b0 with m > h
+    size_t h = n / 2;
+    mul_limbs(a, h, b, h, res);
+    mul_limbs(a + h, n - h, b + h, m - h, res + 2 * h);
+    std::vector<uint32_t> sa(n - h + 1, 0), sb(std::max(h, m - h) + 1, 0);
+    std::copy(a + h, a + n, sa.begin());
+    add_limbs(sa.data(), sa.size(), a, h);
+    std::copy(b + h, b + m, sb.begin());
+    add_limbs(sb.data(), sb.size(), b, h);
+    size_t sa_len = trimmed(sa.data(), sa.size()), sb_len = trimmed(sb.data(), sb.size());
+    std::vector<uint32_t> mid(sa_len + sb_len, 0);
+    mul_limbs(sa.data(), sa_len, sb.data(), sb_len, mid.data());
+    sub_limbs(mid.data(), mid.size(), res, 2 * h);
+    sub_limbs(mid.data(), mid.size(), res + 2 * h, n + m - 2 * h);
+    add_limbs(res + h, n + m - h, mid.data(), trimmed(mid.data(), mid.size()));
+}
+
+// res[0, 2n) = a * a: every cross product is computed once and doubled
+static void sqr_limbs(uint32_t const* a, size_t n, uint32_t* res) {
+    if (n < karatsuba_threshold()) {
+        for (size_t i = 0; i < n; i++) {
+            res[i + n] = addmul_1(res + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+        }
+        uint32_t top = 0;
+        for (size_t k = 0; k < 2 * n; k++) {
+            uint32_t cur = res[k];
+            res[k] = (cur << 1u) | top;
+            top = (cur >> 31u);
+        }
+        uint64_t carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            uint64_t lo = static_cast<uint64_t>(a[i]) * static_cast<uint64_t>(a[i]) + res[2 * i] + carry;
+            res[2 * i] = static_cast<uint32_t>(lo);
+            uint64_t hi = (lo >> 32u) + res[2 * i + 1];
+            res[2 * i + 1] = static_cast<uint32_t>(hi);
+            carry = (hi >> 32u);
+        }
+        return;
+    }
+    size_t h = n / 2;
+    sqr_limbs(a, h, res);
+    sqr_limbs(a + h, n - h, res + 2 * h);
+    std::vector<uint32_t> sa(n - h + 1, 0);
+    std::copy(a + h, a + n, sa.begin());
+    add_limbs(sa.data(), sa.size(), a, h);
+    size_t sa_len = trimmed(sa.data(), sa.size());
+    std::vector<uint32_t> mid(2 * sa_len, 0);
+    sqr_limbs(sa.data(), sa_len, mid.data());
+    sub_limbs(mid.data(), mid.size(), res, 2 * h);
+    sub_limbs(mid.data(), mid.size(), res + 2 * h, 2 * (n - h));
+    add_limbs(res + h, 2 * n - h, mid.data(), trimmed(mid.data(), mid.size()));
+}
+
+storage big_integer::multiply(storage const& lhs, storage const& rhs) {
+    uint32_t const* a = lhs.limbs();
+    uint32_t const* b = rhs.limbs();
+    size_t n = trimmed(a, lhs.size()), m = trimmed(b, rhs.size());
+    storage product;
+    product.resize(n + m);
+    if (a == b && n == m) {
+        sqr_limbs(a, n, product.prepare_write(n + m));
+    } else {
+        mul_limbs(a, n, b, m, product.prepare_write(n + m));
+    }
+    return product;
+}
+
+// a single carry pass over all terms: -x is added as ~x with its +1 folded
+// into the initial carry, two spare limbs hold the growth and the sign
+big_integer big_integer::signed_sum(big_integer const* const* terms, bool const* negated, size_t count) {
+    size_t n = 0;
+    uint64_t carry = 0;
+    for (size_t i = 0; i < count; i++) {
+        n = std::max(n, terms[i]->mas.size());
+        carry += negated[i];
+    }
+    big_integer res;
+    res.mas.resize(n + 2);
+    uint32_t* out = res.mas.prepare_write(n + 2);
+    for (size_t j = 0; j < n + 2; j++) {
+        uint64_t cur = carry;
+        for (size_t i = 0; i < count; i++) {
+            uint32_t limb = (*terms[i])[j];
+            cur += (negated[i] ? ~limb : limb);
+        }
+        out[j] = static_cast<uint32_t>(cur);
+        carry = (cur >> 32u);
+    }
+    res.set_sign((out[n + 1] >> 31u) == 0);
+    return res;
+}
+
+// a * b + c (a * b - c when subtract is set): the rows of |a| * |b| are
+// accumulated straight into a sign-extended copy of the addend, so no
+// separate product is allocated
+big_integer big_integer::multiply_add(big_integer const& a, big_integer const& b, big_integer const& c, bool subtract) {
+    int64_t res_word;
+    if (a.is_word() && b.is_word() && c.is_word() && !__builtin_mul_overflow(a.word(), b.word(), &res_word)
+        && !(subtract ? __builtin_sub_overflow(res_word, c.word(), &res_word)
+                      : __builtin_add_overflow(res_word, c.word(), &res_word))) {
+        return big_integer().set_word(res_word);
+    }
+    bool product_sign = (a.sign() == b.sign());
+    big_integer x = a.abs();
+    big_integer y = b.abs();
+    // for a negative product accumulate into -c' and negate the result back
+    big_integer res = (subtract == product_sign ? -c : c);
+    size_t n = x.mas.size(), m = y.mas.size();
+    size_t len = std::max(res.mas.size(), n + m) + 1;
+    res.fill(len);
+    uint32_t* out = res.mas.prepare_write(len);
+    uint32_t const* lhs = x.mas.limbs();
+    uint32_t const* rhs = y.mas.limbs();
     for (size_t i = 0; i < n; i++) {
-        uint64_t rem = 0;
-        for (size_t j = 0; j < m; j++) {
-            uint64_t cur = static_cast<uint64_t>(a[i]) * static_cast<uint64_t>(b[j]) + res[i + j] + rem;
-            res[i + j] = static_cast<uint32_t>(cur);
+        uint64_t rem = addmul_1(out + i, rhs, m, lhs[i]);
+        for (size_t k = i + m; rem != 0 && k < len; k++) {
+            uint64_t cur = static_cast<uint64_t>(out[k]) + rem;
+            out[k] = static_cast<uint32_t>(cur);
             rem = (cur >> 32u);
         }
-        if (rem != 0) {
-            res[i + m] += static_cast<uint32_t>(rem);
-        }
+    }
+    res.set_sign((out[len - 1] >> 31u) == 0);
+    if (!product_sign) {
+        res.negate();
     }
     return res;
 }
 
 big_integer big_integer::abs() const {
-    if (sign) {
+    if (sign()) {
         return *this;
     } else {
         return -(*this);
@@ -256,27 +536,33 @@ big_integer big_integer::abs() const {
 }
 
 big_integer &big_integer::operator*=(const big_integer &rhs) {
+    int64_t res_word;
+    if (is_word() && rhs.is_word() && !__builtin_mul_overflow(word(), rhs.word(), &res_word)) {
+        return set_word(res_word);
+    }
     if (rhs == 0) {
         return *this = 0;
     }
     storage new_mas;
     bool new_sign = true;
-    if (sign != rhs.sign) {
-        if (sign) {
-            new_mas = multiply(mas.get_mas_copy(), (-rhs).mas.get_mas_copy());
+    if (sign() != rhs.sign()) {
+        if (sign()) {
+            new_mas = multiply(mas, (-rhs).mas);
         } else {
-            new_mas = multiply((-(*this)).mas.get_mas_copy(), rhs.mas.get_mas_copy());
+            new_mas = multiply((-(*this)).mas, rhs.mas);
         }
         new_sign = false;
     } else {
-        if (sign) {
-            new_mas = multiply(mas.get_mas_copy(), rhs.mas.get_mas_copy());
+        if (sign()) {
+            new_mas = multiply(mas, rhs.mas);
+        } else if (this == &rhs) {
+            big_integer a = -(*this);
+            new_mas = multiply(a.mas, a.mas);
         } else {
-            new_mas = multiply((-(*this)).mas.get_mas_copy(), (-rhs).mas.get_mas_copy());
+            new_mas = multiply((-(*this)).mas, (-rhs).mas);
         }
     }
-    sign = true;
-    mas = new_mas;
+    mas = std::move(new_mas);
     shrink_to_fit();
     if (!new_sign) {
         negate();
@@ -290,27 +576,35 @@ big_integer operator*(big_integer a, const big_integer& b) {
 }
 
 big_integer& big_integer::div(uint32_t b) {
+    div_rem(b);
+    return *this;
+}
+
+uint32_t big_integer::div_rem(uint32_t b) {
     if (b == 0) {
         throw std::runtime_error("divide by zero");
     }
     uint64_t rem = 0;
-    storage new_mas = mas;
+    uint32_t* res = mas.prepare_write(mas.size());
     for (size_t i = mas.size(); i >= 1; i--) {
-        uint64_t tmp = (*this)[i - 1];
-        uint32_t cur = static_cast<uint32_t>((tmp + (rem << 32u)) / b);
-        new_mas[i - 1] = cur;
-        rem = (tmp + (rem << 32u)) % b;
+        uint64_t cur = res[i - 1] + (rem << 32u);
+        res[i - 1] = static_cast<uint32_t>(cur / b);
+        rem = cur % b;
     }
-    mas = new_mas;
-    return shrink_to_fit();
+    shrink_to_fit();
+    return static_cast<uint32_t>(rem);
 }
 
 big_integer& big_integer::operator/=(const big_integer& rhs) {
-    big_integer a = abs();
-    big_integer b = rhs.abs();
-    bool new_sign = (sign != rhs.sign);
+    if (is_word() && rhs.is_word() && rhs.word() != 0 && !(word() == INT64_MIN && rhs.word() == -1)) {
+        return set_word(word() / rhs.word());
+    }
+    big_integer a = abs().shrink_to_fit();
+    big_integer b = rhs.abs().shrink_to_fit();
+    bool new_sign = (sign() != rhs.sign());
     if (b.mas.size() == 1) {
-        *this = a.div(b[0]);
+        a.div(b[0]);
+        *this = std::move(a);
         if (new_sign) {
             negate();
         }
@@ -319,40 +613,46 @@ big_integer& big_integer::operator/=(const big_integer& rhs) {
     if (a < b) {
         return (*this = 0);
     }
+    // the two-limb trial quotient is off by at most one only when the top
+    // bit of the divisor is set, scaling both operands keeps the quotient
+    int scale = __builtin_clz(b.mas.back());
+    if (scale != 0) {
+        a.mul(1u << scale);
+        b.mul(1u << scale);
+    }
     a.mas.push_back(0);
     size_t n = a.mas.size();
     size_t m = b.mas.size();
     *this = 0;
     fill(n - m + 1);
+    uint32_t* quotient = mas.prepare_write(n - m + 1);
+    uint32_t* rest = a.mas.prepare_write(n);
     __uint128_t y = b[m - 1], z = b[m - 2];
     size_t N = n - m - 1;
     for (size_t t = 0; t <= N; t++) {
         __uint128_t v = a[n - t - 1], w = a[n - t - 2], x = a[n - t - 3];
         __uint128_t trial = (x ^ (w << 32u) ^ (v << 64u)) / ((y << 32u) ^ z);
-        uint32_t cur = std::min(static_cast<uint32_t>(trial), MAX_DIGIT);
+        uint32_t cur = static_cast<uint32_t>(std::min(trial, static_cast<__uint128_t>(MAX_DIGIT)));
         big_integer bx = b;
         bx.mul(cur);
         bool decrease = false;
         size_t i = n - m - t - 1;
-        if (t != N) {
-            for (size_t j = m + i, k = j - i; j >= i; j--, k--) {
-                if (a[j] != bx[k]) {
-                    decrease = a[j] < bx[k];
-                    break;
-                }
+        for (size_t j = m + i + 1; j-- > i;) {
+            if (a[j] != bx[j - i]) {
+                decrease = a[j] < bx[j - i];
+                break;
             }
         }
         if (decrease) {
             cur--;
             bx -= b;
         }
-        mas[i] = cur;
-        uint64_t tmp;
-        cur = 0;
+        quotient[i] = cur;
+        uint64_t borrow = 0;
         for (size_t j = i; j <= i + m; j++) {
-            tmp = (static_cast<uint64_t>(a[j]) - bx[j - i] - cur);
-            cur = (bx[j - i] + cur) > a[j];
-            a.mas[j] = static_cast<uint32_t>(tmp);
+            uint64_t tmp = static_cast<uint64_t>(a[j]) - bx[j - i] - borrow;
+            borrow = (tmp >> 63u);
+            rest[j] = static_cast<uint32_t>(tmp);
         }
     }
     if (new_sign) {
@@ -361,64 +661,255 @@ big_integer& big_integer::operator/=(const big_integer& rhs) {
     return shrink_to_fit();
 }
 
+// not streaming: all base 10^9 blocks are computed by repeated div_rem before
+// the first is written, only the std::string of every digit is never built
 std::ostream& operator<<(std::ostream& s, const big_integer& a) {
-    s << to_string(a);
+    std::ostream::sentry guard(s);
+    if (!guard) {
+        return s;
+    }
+    std::vector<uint32_t> blocks = a.decimal_blocks();
+    size_t len = (blocks.empty() ? 1 : (blocks.size() - 1) * DECIMAL_BLOCK_DIGITS) + (a.sign() ? 0 : 1);
+    if (!blocks.empty()) {
+        for (uint32_t top = blocks.back(); top != 0; top /= 10) {
+            len++;
+        }
+    }
+    std::streambuf* out = s.rdbuf();
+    std::streamsize padding = std::max<std::streamsize>(s.width() - static_cast<std::streamsize>(len), 0);
+    std::ios_base::fmtflags adjust = (s.flags() & std::ios_base::adjustfield);
+    bool ok = true;
+    if (!a.sign() && adjust == std::ios_base::internal) {
+        ok &= (out->sputc('-') != std::char_traits<char>::eof());
+    }
+    if (adjust != std::ios_base::left) {
+        ok &= (out->sputn(std::string(padding, s.fill()).data(), padding) == padding);
+    }
+    if (!a.sign() && adjust != std::ios_base::internal) {
+        ok &= (out->sputc('-') != std::char_traits<char>::eof());
+    }
+    if (blocks.empty()) {
+        ok &= (out->sputc('0') != std::char_traits<char>::eof());
+    }
+    char buf[DECIMAL_BLOCK_DIGITS];
+    for (size_t i = blocks.size(); i >= 1 && ok; i--) {
+        std::streamsize n = static_cast<std::streamsize>(write_block(buf, blocks[i - 1], i != blocks.size()));
+        ok &= (out->sputn(buf, n) == n);
+    }
+    if (adjust == std::ios_base::left) {
+        ok &= (out->sputn(std::string(padding, s.fill()).data(), padding) == padding);
+    }
+    s.width(0);
+    if (!ok) {
+        s.setstate(std::ios_base::badbit);
+    }
+    return s;
+}
+
+std::istream& operator>>(std::istream& s, big_integer& a) {
+    std::istream::sentry guard(s);
+    if (!guard) {
+        return s;
+    }
+    std::streambuf* in = s.rdbuf();
+    typedef std::char_traits<char> traits;
+    traits::int_type c = in->sgetc();
+    traits::int_type sign = traits::eof();
+    if (c == '-' || c == '+') {
+        sign = c;
+        c = in->snextc();
+    }
+    std::vector<uint32_t> blocks;
+    uint32_t block = 0;
+    size_t block_len = 0;
+    bool any_digit = false;
+    while (!traits::eq_int_type(c, traits::eof()) && isdigit(traits::to_char_type(c))) {
+        any_digit = true;
+        block = block * 10 + static_cast<uint32_t>(traits::to_char_type(c) - '0');
+        if (++block_len == DECIMAL_BLOCK_DIGITS) {
+            blocks.push_back(block);
+            block = 0;
+            block_len = 0;
+        }
+        c = in->snextc();
+    }
+    std::ios_base::iostate state = std::ios_base::goodbit;
+    if (traits::eq_int_type(c, traits::eof())) {
+        state |= std::ios_base::eofbit;
+    }
+    if (!any_digit) {
+        // a sign without digits is left in the stream for the next reader
+        if (!traits::eq_int_type(sign, traits::eof()) &&
+            !traits::eq_int_type(in->sputbackc(traits::to_char_type(sign)), traits::eof())) {
+            state = std::ios_base::goodbit;
+        }
+        s.setstate(state | std::ios_base::failbit);
+        return s;
+    }
+    big_integer res = big_integer::from_decimal_digits(blocks, block, block_len);
+    if (sign == '-') {
+        res.negate();
+    }
+    a = res;
+    s.setstate(state);
     return s;
 }
 
 big_integer& big_integer::operator%=(big_integer const& rhs) {
+    if (is_word() && rhs.is_word() && rhs.word() != 0 && !(word() == INT64_MIN && rhs.word() == -1)) {
+        return set_word(word() % rhs.word());
+    }
     *this = (*this - (*this / rhs) * rhs);
     return *this;
 }
 
-big_integer& big_integer::bit_operator(big_integer const& rhs,  const std::function<uint32_t(uint32_t, uint32_t)> &function) {
-    fill(rhs.mas.size());
-    for (size_t i = 0; i < rhs.mas.size(); i++) {
-        mas[i] = function(rhs[i], mas[i]);
+// The limbs past the end of the shorter operand meet its sign extension
+// without it being written out. When that extension absorbs them (x & 0,
+// x | -1) the result is as long as the shorter operand, when it leaves them
+// as they are (x & -1, x | 0, x ^ 0) they are not written, so a shared
+// buffer is not copied.
+template<typename Op>
+big_integer& big_integer::bit_operator(big_integer const& rhs) {
+    size_t n = mas.size();
+    size_t m = rhs.mas.size();
+    uint32_t lhs_end = get_end_of_mas();
+    uint32_t rhs_end = rhs.get_end_of_mas();
+    uint32_t res_end = lhs_end;
+    Op::apply(res_end, rhs_end);
+    // the extension of the shorter operand applied to all-zero and all-one limbs
+    uint32_t short_end = (n < m ? lhs_end : rhs_end);
+    uint32_t zeros = 0, ones = MAX_DIGIT;
+    Op::apply(zeros, short_end);
+    Op::apply(ones, short_end);
+    size_t common = std::min(n, m);
+    if (zeros == ones) {
+        mas.resize(common);
+        uint32_t* res = mas.prepare_write(common);
+        bitwise_n<Op>(res, res, rhs.mas.limbs(), common);
+    } else if (n >= m) {
+        size_t touched = (zeros == 0 && ones == MAX_DIGIT ? m : n);
+        uint32_t* res = mas.prepare_write(touched);
+        bitwise_n<Op>(res, res, rhs.mas.limbs(), m);
+        bitwise_1<Op>(res + m, res + m, rhs_end, touched - m);
+    } else {
+        mas.resize(m);
+        uint32_t* res = mas.prepare_write(m);
+        uint32_t const* other = rhs.mas.limbs();
+        bitwise_n<Op>(res, res, other, n);
+        bitwise_1<Op>(res + n, other + n, lhs_end, m - n);
     }
-    sign = !function(!sign, !rhs.sign);
-    return shrink_to_fit();
+    set_sign(res_end == 0);
+    return *this;
 }
 
 big_integer& big_integer::operator&=(big_integer const& rhs) {
-    return bit_operator(rhs, [](uint32_t x, uint32_t y) { return x & y;});
+    return bit_operator<bit_and>(rhs);
 }
 
 big_integer& big_integer::operator|=(big_integer const& rhs) {
-    return bit_operator(rhs, [](uint32_t x, uint32_t y) { return x | y;});
+    return bit_operator<bit_or>(rhs);
 }
 
 big_integer& big_integer::operator^=(big_integer const& rhs) {
-    return bit_operator(rhs, [](uint32_t x, uint32_t y) { return x ^ y;});
+    return bit_operator<bit_xor>(rhs);
+}
+
+// dst[0, n] = src[0, n) << bits with `high` above src, for 0 < bits < 32.
+// Walks down, so dst may overlap src from above
+static void shl_limbs(uint32_t* dst, uint32_t const* src, size_t n, uint32_t high, unsigned bits) {
+    for (size_t i = n; i-- > 0;) {
+        uint32_t low = src[i];
+        dst[i + 1] = (high << bits) | (low >> (32 - bits));
+        high = low;
+    }
+    dst[0] = (high << bits);
+}
+
+// dst[0, n) = src[0, n) >> bits with `high` above src, for 0 < bits < 32.
+// Walks up, so dst may overlap src from below
+static void shr_limbs(uint32_t* dst, uint32_t const* src, size_t n, uint32_t high, unsigned bits) {
+    for (size_t i = 0; i + 1 < n; i++) {
+        dst[i] = (src[i] >> bits) | (src[i + 1] << (32 - bits));
+    }
+    if (n > 0) {
+        dst[n - 1] = (src[n - 1] >> bits) | (high << (32 - bits));
+    }
 }
 
+// Shifts work on the two's complement limbs directly, so >> rounds towards
+// minus infinity without a separate fix-up. The destination is sized once:
+// a buffer owned by this number is shifted in place, a shared one is read
+// straight into a fresh buffer.
 big_integer& big_integer::operator<<=(int rhs) {
     if (rhs < 0) {
         return ((*this) >>= -rhs);
     }
-    size_t n = rhs / 32;
-    size_t m = rhs % 32;
-    big_integer cur = abs().mul(1u << m);
-    cur.mas.reverse();
-    size_t was = cur.mas.size();
-    cur.mas.resize(was + n, 0);
-    cur.mas.reverse();
-    mas = cur.mas;
-    if (!sign) {
-        cur = -cur;
+    size_t n = significant_size();
+    size_t words = static_cast<unsigned>(rhs) / 32;
+    unsigned bits = static_cast<unsigned>(rhs) % 32;
+    bool negative = !sign();
+    if (n == 0 && !negative) {
+        mas.resize(0);
+        return *this;
+    }
+    uint32_t end = get_end_of_mas();
+    size_t len = n + words + (bits != 0);
+    storage res;
+    uint32_t const* src;
+    if (mas.is_shared()) {
+        res.resize(len);
+        src = mas.limbs();
+    } else {
+        mas.resize(std::max(len, mas.size()));
+        res = std::move(mas);
+        src = res.limbs();
+    }
+    uint32_t* out = res.prepare_write(len);
+    if (bits == 0) {
+        std::memmove(out + words, src, n * sizeof(uint32_t));
+    } else {
+        shl_limbs(out + words, src, n, end, bits);
     }
-    return (*this = cur);
+    std::fill(out, out + words, 0);
+    res.resize(len);
+    mas = std::move(res);
+    set_sign(!negative);
+    return *this;
 }
 
 big_integer& big_integer::operator>>=(int rhs) {
     if (rhs < 0) {
         return ((*this) <<= -rhs);
     }
-    size_t n = rhs / 32;
-    size_t m = rhs % 32;
-    big_integer cur = abs().div(1u << m);
-    cur.mas.erase(0, n);
-    *this = (sign ? cur : -cur - 1);
+    size_t n = significant_size();
+    size_t words = static_cast<unsigned>(rhs) / 32;
+    unsigned bits = static_cast<unsigned>(rhs) % 32;
+    if (words >= n) {
+        // only the sign extension is left: 0 or -1
+        mas.resize(0);
+        return *this;
+    }
+    bool negative = !sign();
+    uint32_t end = get_end_of_mas();
+    size_t len = n - words;
+    storage res;
+    uint32_t const* src;
+    if (mas.is_shared()) {
+        res.resize(len);
+        src = mas.limbs() + words;
+    } else {
+        res = std::move(mas);
+        src = res.limbs() + words;
+    }
+    uint32_t* out = res.prepare_write(len);
+    if (bits == 0) {
+        std::memmove(out, src, len * sizeof(uint32_t));
+    } else {
+        shr_limbs(out, src, len, end, bits);
+    }
+    res.resize(len);
+    mas = std::move(res);
+    set_sign(!negative);
     return *this;
 }
 
@@ -426,16 +917,74 @@ uint32_t big_integer::operator[](size_t pos) const {
     return static_cast<uint32_t>((pos >= mas.size()) ? get_end_of_mas() : mas[pos]);
 }
 
-big_integer operator/(big_integer a, big_integer const& b) { return (a /= b); }
+big_integer operator/(big_integer a, big_integer const& b) {
+    a /= b;
+    return a;
+}
+
+big_integer operator%(big_integer a, big_integer const& b) {
+    a %= b;
+    return a;
+}
+
+big_integer operator&(big_integer a, big_integer const& b) {
+    a &= b;
+    return a;
+}
+
+big_integer operator|(big_integer a, big_integer const& b) {
+    a |= b;
+    return a;
+}
 
-big_integer operator%(big_integer a, big_integer const& b) { return (a %= b); }
+big_integer operator^(big_integer a, big_integer const& b) {
+    a ^= b;
+    return a;
+}
 
-big_integer operator&(big_integer a, big_integer const& b) { return (a &= b); }
+big_integer operator<<(big_integer a, int b) {
+    a <<= b;
+    return a;
+}
 
-big_integer operator|(big_integer a, big_integer const& b) { return (a |= b); }
+big_integer operator>>(big_integer a, int b) {
+    a >>= b;
+    return a;
+}
 
-big_integer operator^(big_integer a, big_integer const& b) { return (a ^= b); }
+big_integer&& big_integer::reuse_unshared(big_integer& a, big_integer& b) {
+    if (a.mas.is_shared() && !b.mas.is_shared()) {
+        swap(a, b);
+    }
+    return std::move(a);
+}
 
-big_integer operator<<(big_integer a, int b) { return (a <<= b); }
+big_integer operator+(big_integer&& a, big_integer&& b) {
+    big_integer res = big_integer::reuse_unshared(a, b);
+    res += b;
+    return res;
+}
 
-big_integer operator>>(big_integer a, int b) { return (a >>= b); }
\ No newline at end of file
+big_integer operator*(big_integer&& a, big_integer&& b) {
+    big_integer res = big_integer::reuse_unshared(a, b);
+    res *= b;
+    return res;
+}
+
+big_integer operator&(big_integer&& a, big_integer&& b) {
+    big_integer res = big_integer::reuse_unshared(a, b);
+    res &= b;
+    return res;
+}
+
+big_integer operator|(big_integer&& a, big_integer&& b) {
+    big_integer res = big_integer::reuse_unshared(a, b);
+    res |= b;
+    return res;
+}
+
+big_integer operator^(big_integer&& a, big_integer&& b) {
+    big_integer res = big_integer::reuse_unshared(a, b);
+    res ^= b;
+    return res;
+}
@@ -4,7 +4,6 @@
 #include <algorithm>
 #include "storage.h"
 #include <cstddef>
-#include <functional>
 #include <gmp.h>
 #include <iosfwd>
 #include <string>
@@ -15,10 +14,12 @@ struct big_integer
 {
     big_integer();
     big_integer(big_integer const& other);
+    big_integer(big_integer&& other) noexcept;
     big_integer(int a);
     explicit big_integer(std::string const& str);
     ~big_integer();
     big_integer& operator=(big_integer const& other);
+    big_integer& operator=(big_integer&& other) noexcept;
 
     big_integer& operator+=(big_integer const& rhs);
     big_integer& operator-=(big_integer const& rhs);
@@ -50,24 +51,52 @@ struct big_integer
     friend bool operator<=(big_integer const& a, big_integer const& b);
     friend bool operator>=(big_integer const& a, big_integer const& b);
 
-    friend std::string to_string(big_integer const& a);
+    friend big_integer operator+(big_integer&& a, big_integer&& b);
+    friend big_integer operator*(big_integer&& a, big_integer&& b);
+    friend big_integer operator&(big_integer&& a, big_integer&& b);
+    friend big_integer operator|(big_integer&& a, big_integer&& b);
+    friend big_integer operator^(big_integer&& a, big_integer&& b);
 
     friend std::string to_string(big_integer const& a);
+    friend std::ostream& operator<<(std::ostream& s, big_integer const& a);
+    friend std::istream& operator>>(std::istream& s, big_integer& a);
+
     friend void swap(big_integer &a, big_integer &b);
+    friend struct power_cache;
+    friend struct arena_scope;
+    friend struct big_integer_expr;
+    friend struct sum_accumulator;
+    template<size_t Bits> friend struct fixed_big_integer;
+    template<char... Chars> friend struct big_integer_literal;
 private:
-    static storage multiply(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b);
+    static big_integer from_limbs(uint32_t const* limbs, size_t count);
+    static storage multiply(storage const& lhs, storage const& rhs);
+    static big_integer signed_sum(big_integer const* const* terms, bool const* negated, size_t count);
+    static big_integer multiply_add(big_integer const& a, big_integer const& b, big_integer const& c, bool subtract);
     uint32_t operator[](size_t pos) const;
+    size_t significant_size() const;
     big_integer& shrink_to_fit();
     void fill(size_t size);
     big_integer& div(uint32_t b);
     big_integer& mul(uint32_t rhs);
+    big_integer& mul_add(uint32_t rhs, uint32_t add);
+    uint32_t div_rem(uint32_t b);
+    std::vector<uint32_t> decimal_blocks() const;
+    static big_integer from_decimal_blocks(uint32_t const* blocks, size_t count);
+    static big_integer from_decimal_digits(std::vector<uint32_t>& blocks, uint32_t tail, size_t tail_len);
     big_integer& negate();
     big_integer abs() const;
-    big_integer& bit_operator(big_integer const& a,  const std::function<uint32_t(uint32_t, uint32_t)> &function);
+    template<typename Op>
+    big_integer& bit_operator(big_integer const& rhs);
     uint32_t get_end_of_mas() const;
+    bool sign() const;
+    void set_sign(bool value);
+    bool is_word() const;
+    int64_t word() const;
+    big_integer& set_word(int64_t value);
+    static big_integer&& reuse_unshared(big_integer& a, big_integer& b);
 private:
     storage mas;
-    bool sign;
 };
 
 
@@ -81,6 +110,12 @@ big_integer operator&(big_integer a, big_integer const& b);
 big_integer operator|(big_integer a, big_integer const& b);
 big_integer operator^(big_integer a, big_integer const& b);
 
+big_integer operator+(big_integer&& a, big_integer&& b);
+big_integer operator*(big_integer&& a, big_integer&& b);
+big_integer operator&(big_integer&& a, big_integer&& b);
+big_integer operator|(big_integer&& a, big_integer&& b);
+big_integer operator^(big_integer&& a, big_integer&& b);
+
 big_integer operator<<(big_integer a, int b);
 big_integer operator>>(big_integer a, int b);
 
@@ -93,5 +128,6 @@ bool operator>=(big_integer const& a, big_integer const& b);
 
 std::string to_string(big_integer const& a);
 std::ostream& operator<<(std::ostream& s, big_integer const& a);
+std::istream& operator>>(std::istream& s, big_integer& a);
 
 #endif // BIG_INTEGER_H
\ No newline at end of file
@@ -0,0 +1,317 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include "big_integer_algorithm.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+// subtrees smaller than this are not worth a thread
+static const size_t PARALLEL_MIN_COUNT = 64;
+// values reduced by one task of parallel_sum and parallel_product
+static const size_t PARALLEL_CHUNK = 4096;
+// binomial(n, k) with k below n / BINOMIAL_WINDOW_RATIO divides k! out of
+// n - k + 1, ..., n rather than sieving every prime up to n
+static const uint32_t BINOMIAL_WINDOW_RATIO = 4;
+
+sum_accumulator::sum_accumulator() : pending(0) {}
+
+sum_accumulator& sum_accumulator::operator+=(big_integer const& term) {
+    if (pending == FLUSH_INTERVAL) {
+        flush();
+    }
+    pending++;
+    size_t n = term.mas.size();
+    if (borrows.size() < n + 1) {
+        slots.resize(n, 0);
+        borrows.resize(n + 1, 0);
+    }
+    uint32_t const* limbs = term.mas.limbs();
+    uint64_t* out = slots.data();
+    for (size_t i = 0; i < n; i++) {
+        out[i] += limbs[i];
+    }
+    // the sign extension of n limbs is worth -2^(32n)
+    if (!term.sign()) {
+        borrows[n]++;
+    }
+    return *this;
+}
+
+big_integer sum_accumulator::result() const {
+    big_integer res;
+    size_t n = slots.size();
+    res.mas.resize(n + 3);
+    uint32_t* out = res.mas.prepare_write(n + 3);
+    __int128_t carry = 0;
+    for (size_t i = 0; i < n + 3; i++) {
+        if (i < n) {
+            carry += slots[i];
+        }
+        if (i < borrows.size()) {
+            carry -= borrows[i];
+        }
+        out[i] = static_cast<uint32_t>(carry);
+        carry >>= 32;
+    }
+    // the spare limbs take the final carries and the sign
+    res.set_sign(carry == 0);
+    return res.shrink_to_fit();
+}
+
+void sum_accumulator::clear() {
+    slots.clear();
+    borrows.clear();
+    pending = 0;
+}
+
+void sum_accumulator::flush() {
+    big_integer partial = result();
+    clear();
+    *this += partial;
+}
+
+big_integer product_tree(big_integer const* values, size_t count, size_t threads) {
+    if (count == 0) {
+        return 1;
+    }
+    if (count == 1) {
+        return values[0];
+    }
+    size_t half = count / 2;
+#ifndef BIGINT_SINGLE_THREADED
+    if (threads > 1 && count >= PARALLEL_MIN_COUNT) {
+        std::future<big_integer> left;
+        try {
+            left = std::async(std::launch::async, product_tree, values, half, threads / 2);
+        } catch (std::system_error const&) {
+            // no thread to spare, the calling thread does both halves
+            return product_tree(values, half, 1) * product_tree(values + half, count - half, 1);
+        }
+        big_integer right = product_tree(values + half, count - half, threads - threads / 2);
+        return left.get() * right;
+    }
+#endif
+    return product_tree(values, half, 1) * product_tree(values + half, count - half, 1);
+}
+
+// runs task(0), ..., task(count - 1) on up to `threads` workers, the
+// calling thread being one of them; the first exception is rethrown
+template<typename Task>
+static void run_tasks(size_t count, size_t threads, Task const& task) {
+#ifdef BIGINT_SINGLE_THREADED
+    threads = 1;
+#endif
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, count);
+    std::atomic<size_t> next(0);
+    std::exception_ptr error;
+    std::mutex error_lock;
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_lock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next = count;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t i = 1; i < threads; i++) {
+        try {
+            pool.emplace_back(worker);
+        } catch (std::system_error const&) {
+            // the workers already running take over the rest
+            break;
+        }
+    }
+    worker();
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// reduces every chunk of values by chunk_op, then pairs up the partial
+// results level by level until one is left
+template<typename ChunkOp, typename Combine>
+static big_integer parallel_reduce(std::vector<big_integer> const& values, size_t threads,
+                                   ChunkOp const& chunk_op, Combine const& combine) {
+    std::vector<big_integer> level((values.size() + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK);
+    run_tasks(level.size(), threads, [&](size_t i) {
+        size_t lo = i * PARALLEL_CHUNK;
+        level[i] = chunk_op(values.data() + lo, std::min(PARALLEL_CHUNK, values.size() - lo));
+    });
+    while (level.size() > 1) {
+        std::vector<big_integer> upper((level.size() + 1) / 2);
+        run_tasks(upper.size(), threads, [&](size_t i) {
+            if (2 * i + 1 < level.size()) {
+                upper[i] = combine(level[2 * i], level[2 * i + 1]);
+            } else {
+                upper[i] = std::move(level[2 * i]);
+            }
+        });
+        level.swap(upper);
+    }
+    return std::move(level[0]);
+}
+
+big_integer parallel_sum(std::vector<big_integer> const& values, size_t threads) {
+    if (values.empty()) {
+        return 0;
+    }
+    return parallel_reduce(values, threads, [](big_integer const* chunk, size_t count) {
+        return sum(chunk, chunk + count);
+    }, [](big_integer const& a, big_integer const& b) {
+        return a + b;
+    });
+}
+
+big_integer parallel_product(std::vector<big_integer> const& values, size_t threads) {
+    if (values.empty()) {
+        return 1;
+    }
+    return parallel_reduce(values, threads, [](big_integer const* chunk, size_t count) {
+        return product_tree(chunk, count);
+    }, [](big_integer const& a, big_integer const& b) {
+        return a * b;
+    });
+}
+
+// primes not exceeding n, sieve of Eratosthenes over odd numbers
+static std::vector<uint32_t> primes_up_to(uint32_t n) {
+    std::vector<uint32_t> primes;
+    if (n < 2) {
+        return primes;
+    }
+    primes.push_back(2);
+    std::vector<bool> composite(n / 2 + 1, false);
+    for (uint64_t i = 3; i <= n; i += 2) {
+        if (composite[i / 2]) {
+            continue;
+        }
+        primes.push_back(static_cast<uint32_t>(i));
+        for (uint64_t j = i * i; j <= n; j += 2 * i) {
+            composite[j / 2] = true;
+        }
+    }
+    return primes;
+}
+
+// a limb as a big_integer, whose only integral constructor takes an int
+static big_integer from_limb(uint32_t limb) {
+    if (limb <= INT32_MAX) {
+        return big_integer(static_cast<int>(limb));
+    }
+    return (big_integer(static_cast<int>(limb >> 1u)) << 1) + static_cast<int>(limb & 1u);
+}
+
+// packs as many factors into each limb as fit before the product tree
+static big_integer product_of_factors(std::vector<uint32_t> const& factors) {
+    std::vector<big_integer> words;
+    uint64_t word = 1;
+    for (uint32_t factor : factors) {
+        if (word * factor > UINT32_MAX) {
+            words.push_back(from_limb(static_cast<uint32_t>(word)));
+            word = 1;
+        }
+        word *= factor;
+    }
+    words.push_back(from_limb(static_cast<uint32_t>(word)));
+    return product_tree(words.data(), words.size());
+}
+
+// swing(n) = n! / ((n / 2)!)^2, p divides it sum over k of floor(n / p^k) mod 2 times
+static big_integer swing(uint32_t n, std::vector<uint32_t> const& primes) {
+    std::vector<uint32_t> factors;
+    for (uint32_t p : primes) {
+        if (p > n) {
+            break;
+        }
+        for (uint64_t q = n / p; q > 0; q /= p) {
+            if (q % 2 == 1) {
+                factors.push_back(p);
+            }
+        }
+    }
+    return product_of_factors(factors);
+}
+
+static big_integer swing_factorial(uint32_t n, std::vector<uint32_t> const& primes) {
+    if (n < 2) {
+        return 1;
+    }
+    big_integer half = swing_factorial(n / 2, primes);
+    half *= half;
+    return half * swing(n, primes);
+}
+
+big_integer factorial(uint32_t n) {
+    return swing_factorial(n, primes_up_to(n));
+}
+
+// C(n, k) as the factors n - k + 1, ..., n with k! divided out of them
+// prime by prime, which only needs the primes up to k
+static big_integer binomial_window(uint32_t n, uint32_t k) {
+    uint64_t low = n - k + 1;
+    std::vector<uint32_t> factors(k);
+    for (uint32_t i = 0; i < k; i++) {
+        factors[i] = static_cast<uint32_t>(low + i);
+    }
+    for (uint32_t p : primes_up_to(k)) {
+        uint64_t power = 0;
+        for (uint64_t q = k / p; q > 0; q /= p) {
+            power += q;
+        }
+        for (uint64_t m = (low + p - 1) / p * p; power > 0; m += p) {
+            uint32_t& factor = factors[m - low];
+            do {
+                factor /= p;
+                power--;
+            } while (power > 0 && factor % p == 0);
+        }
+    }
+    return product_of_factors(factors);
+}
+
+// the power of p in C(n, k) is the number of borrows in n - k written in base p
+big_integer binomial(uint32_t n, uint32_t k) {
+    if (k > n) {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    if (k < n / BINOMIAL_WINDOW_RATIO) {
+        return binomial_window(n, k);
+    }
+    std::vector<uint32_t> factors;
+    for (uint32_t p : primes_up_to(n)) {
+        uint64_t a = n, b = k, borrow = 0;
+        while (a > 0) {
+            bool next = (a % p < b % p + borrow);
+            if (next) {
+                factors.push_back(p);
+            }
+            borrow = next;
+            a /= p;
+            b /= p;
+        }
+    }
+    return product_of_factors(factors);
+}
+
+big_integer primorial(uint32_t n) {
+    return product_of_factors(primes_up_to(n));
+}
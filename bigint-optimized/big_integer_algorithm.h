@@ -0,0 +1,70 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_BIG_INTEGER_ALGORITHM_H
+#define BIGINT_BIG_INTEGER_ALGORITHM_H
+
+#include "big_integer.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Carry-save sum of many terms. Every limb of a term goes into its own
+// 64-bit slot without carrying, a negative term of n limbs additionally
+// records one 2^(32n) to subtract. Carries are resolved once by result().
+struct sum_accumulator {
+    sum_accumulator();
+
+    sum_accumulator& operator+=(big_integer const& term);
+    big_integer result() const;
+    void clear();
+private:
+    void flush();
+private:
+    // a slot absorbs this many 32-bit limbs before it may overflow
+    static const size_t FLUSH_INTERVAL = UINT32_MAX;
+    std::vector<uint64_t> slots;
+    std::vector<uint64_t> borrows;
+    size_t pending;
+};
+
+template<typename InputIt>
+big_integer sum(InputIt first, InputIt last) {
+    sum_accumulator acc;
+    for (; first != last; ++first) {
+        acc += *first;
+    }
+    return acc.result();
+}
+
+// Product of count values by a balanced product tree, so both operands of
+// every multiplication are of similar size. With threads > 1 the two halves
+// of a subtree run concurrently until the thread budget is spent; the
+// result does not depend on the thread count.
+big_integer product_tree(big_integer const* values, size_t count, size_t threads = 1);
+
+template<typename InputIt>
+big_integer product(InputIt first, InputIt last, size_t threads = 1) {
+    std::vector<big_integer> values(first, last);
+    return product_tree(values.data(), values.size(), threads);
+}
+
+// Reductions of a whole vector on a pool of up to `threads` workers, 0
+// meaning one per hardware thread. The vector is cut into chunks of a fixed
+// length, each chunk is reduced by one worker and the partial results are
+// combined pairwise in a balanced tree. Neither the chunks nor the tree
+// depend on the thread count, so neither does the result.
+big_integer parallel_sum(std::vector<big_integer> const& values, size_t threads = 0);
+big_integer parallel_product(std::vector<big_integer> const& values, size_t threads = 0);
+
+// n! by the prime swing: n! = ((n / 2)!)^2 * swing(n), where the swing is
+// assembled from its prime factorization by a product tree
+big_integer factorial(uint32_t n);
+// C(n, k) from its prime factorization, or for small k from n - k + 1, ..., n
+// with k! divided out of them; 0 when k > n
+big_integer binomial(uint32_t n, uint32_t k);
+// product of all primes not exceeding n
+big_integer primorial(uint32_t n);
+
+#endif //BIGINT_BIG_INTEGER_ALGORITHM_H
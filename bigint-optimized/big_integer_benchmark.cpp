@@ -0,0 +1,582 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arena_scope.h"
+#include "big_integer.h"
+#include "big_integer_algorithm.h"
+#include "big_integer_expr.h"
+#include "big_integer_gmp.h"
+#include "big_integer_literal.h"
+#include "fixed_big_integer.h"
+#include "limb_allocator.h"
+#include "limb_kernels.h"
+#include "storage.h"
+
+namespace {
+#ifdef BIGINT_SINGLE_THREADED
+char const* const REF_COUNTER_MODE = "single-threaded";
+#else
+char const* const REF_COUNTER_MODE = "atomic";
+#endif
+
+template<typename F>
+double nanoseconds_per_op(size_t ops, F const& f) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(finish - start).count() / static_cast<double>(ops);
+}
+
+void report(char const* name, double ns) {
+    std::printf("%-40s %12.2f ns/op\n", name, ns);
+}
+
+big_integer heap_value(size_t digits) {
+    return big_integer(std::string(digits, '7'));
+}
+
+volatile size_t sink;
+
+void bench_ref_counter() {
+    std::printf("reference counters: %s\n", REF_COUNTER_MODE);
+    std::vector<big_integer> values(1000, heap_value(200));
+    size_t const rounds = 2000;
+    report("copy + destroy shared value", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t i = 0; i < rounds; i++) {
+            std::vector<big_integer> copy = values;
+            sink = copy.size();
+        }
+    }));
+
+    big_integer a = heap_value(200), b = heap_value(190);
+    report("a + b (copies a, unshares)", nanoseconds_per_op(rounds * 100, [&a, &b] {
+        for (size_t i = 0; i < rounds * 100; i++) {
+            big_integer c = a + b;
+            sink = (c == a);
+        }
+    }));
+
+#ifndef BIGINT_SINGLE_THREADED
+    size_t const threads_count = 4;
+    report("copy + destroy, 4 threads, same value", nanoseconds_per_op(rounds * values.size(), [&values] {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threads_count; t++) {
+            threads.emplace_back([&values] {
+                for (size_t i = 0; i < rounds / threads_count; i++) {
+                    std::vector<big_integer> copy = values;
+                    sink = copy.size();
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }));
+#endif
+}
+
+struct heap_allocator : limb_allocator {
+    void* allocate(size_t& bytes) override {
+        return ::operator new(bytes);
+    }
+
+    void deallocate(void* ptr, size_t) override {
+        ::operator delete(ptr);
+    }
+};
+
+void temporaries_workload(big_integer const& a, big_integer const& m, size_t rounds) {
+    big_integer x = a;
+    for (size_t i = 0; i < rounds; i++) {
+        x = (x * 3 + static_cast<int>(i)) % m;
+        sink = to_string(-x).size();
+    }
+}
+
+void bench_allocator() {
+    big_integer a = heap_value(300), m = heap_value(150);
+    size_t const rounds = 2000;
+    heap_allocator heap;
+    limb_allocator::set_global(&heap);
+    report("(x * 3 + i) % m, to_string(-x), new", nanoseconds_per_op(rounds, [&a, &m] {
+        temporaries_workload(a, m, rounds);
+    }));
+    limb_allocator::set_global(nullptr);
+    pool_allocator::instance().reset_stats();
+    report("(x * 3 + i) % m, to_string(-x), pool", nanoseconds_per_op(rounds, [&a, &m] {
+        temporaries_workload(a, m, rounds);
+    }));
+    std::printf("pool hit rate: %.2f%%\n", 100 * pool_allocator::instance().stats().hit_rate());
+}
+
+void bench_arena() {
+    big_integer a = heap_value(300), b = heap_value(280), c = heap_value(250), m = heap_value(200);
+    size_t const rounds = 2000;
+    big_integer result;
+    report("(a * b + c) % m, pool", nanoseconds_per_op(rounds, [&] {
+        for (size_t i = 0; i < rounds; i++) {
+            result = (a * b + c) % m;
+        }
+    }));
+    report("(a * b + c) % m, arena_scope", nanoseconds_per_op(rounds, [&] {
+        for (size_t i = 0; i < rounds; i++) {
+            arena_scope arena;
+            result = arena.escape((a * b + c) % m);
+        }
+    }));
+}
+
+std::vector<big_integer> random_values(size_t count, size_t min_limbs, size_t max_limbs) {
+    std::mt19937 rng(42);
+    std::vector<big_integer> res;
+    for (size_t i = 0; i < count; i++) {
+        size_t limbs = min_limbs + rng() % (max_limbs - min_limbs + 1);
+        big_integer x = static_cast<int>(rng() >> 1u) | 1;
+        for (size_t j = 1; j < limbs; j++) {
+            x = (x << 32) + static_cast<int>(rng() >> 1u);
+        }
+        res.push_back(rng() % 2 == 0 ? x : -x);
+    }
+    return res;
+}
+
+void bench_inline_limbs_distribution(size_t min_limbs, size_t max_limbs) {
+    std::vector<big_integer> values = random_values(10000, min_limbs, max_limbs);
+    size_t const rounds = 20;
+    size_t on_heap = 0;
+    for (size_t limbs = min_limbs; limbs <= max_limbs; limbs++) {
+        on_heap += (limbs > storage::SMALL_SIZE);
+    }
+    std::printf("%zu..%zu limbs, %zu of %zu sizes on the heap\n", min_limbs, max_limbs,
+                on_heap, max_limbs - min_limbs + 1);
+    report("copy vector", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t i = 0; i < rounds; i++) {
+            std::vector<big_integer> copy = values;
+            sink = copy.size();
+        }
+    }));
+    report("a[i] + a[i + 1]", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i + 1 < values.size(); i++) {
+                big_integer c = values[i] + values[i + 1];
+                sink = (c == 0);
+            }
+        }
+    }));
+    report("a[i] * a[i + 1]", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i + 1 < values.size(); i++) {
+                big_integer c = values[i] * values[i + 1];
+                sink = (c == 0);
+            }
+        }
+    }));
+}
+
+void bench_inline_limbs() {
+    std::printf("inline limbs: %zu, sizeof(storage): %zu, sizeof(big_integer): %zu\n",
+                storage::SMALL_SIZE, sizeof(storage), sizeof(big_integer));
+    bench_inline_limbs_distribution(2, 4);
+    bench_inline_limbs_distribution(12, 20);
+}
+
+void bench_small_values() {
+    std::mt19937 rng(7);
+    std::vector<big_integer> values;
+    for (size_t i = 0; i < 10000; i++) {
+        values.push_back(static_cast<int>(rng() >> 1u) - (1 << 30));
+    }
+    big_integer const modulo = 1000000007;
+    size_t const rounds = 100;
+    report("(acc * 3 + v) % p", nanoseconds_per_op(rounds * values.size(), [&] {
+        big_integer acc = 1;
+        for (size_t r = 0; r < rounds; r++) {
+            for (big_integer const& v : values) {
+                acc = (acc * 3 + v) % modulo;
+            }
+        }
+        sink = (acc == 0);
+    }));
+    report("v / 7 - v, compare", nanoseconds_per_op(rounds * values.size(), [&] {
+        size_t count = 0;
+        for (size_t r = 0; r < rounds; r++) {
+            for (big_integer const& v : values) {
+                count += (v / 7 - v < v);
+            }
+        }
+        sink = count;
+    }));
+}
+
+void bench_accumulate() {
+    std::vector<big_integer> values = random_values(10000, 2, 6);
+    big_integer const boundary = big_integer(1) << 256;
+    size_t const rounds = 20;
+    report("acc += v[i], acc -= v[i] near 2^256", nanoseconds_per_op(rounds * values.size(), [&] {
+        big_integer acc = boundary;
+        for (size_t r = 0; r < rounds; r++) {
+            for (big_integer const& v : values) {
+                acc += v;
+                acc -= v;
+            }
+        }
+        sink = (acc == boundary);
+    }));
+    report("acc += v[i] - v[i + 1]", nanoseconds_per_op(rounds * values.size(), [&] {
+        big_integer acc = boundary;
+        for (size_t r = 0; r < rounds; r++) {
+            for (size_t i = 0; i + 1 < values.size(); i++) {
+                acc += values[i] - values[i + 1];
+            }
+        }
+        sink = (acc == boundary);
+    }));
+}
+
+void bench_expressions() {
+    big_integer a = heap_value(300), b = heap_value(280), c = -heap_value(290), d = heap_value(50);
+    size_t const rounds = 200000;
+    big_integer r;
+    report("r = a + b - c + d", nanoseconds_per_op(rounds, [&] {
+        for (size_t i = 0; i < rounds; i++) {
+            r = a + b - c + d;
+        }
+    }));
+    report("r = lazy(a) + b - c + d", nanoseconds_per_op(rounds, [&] {
+        for (size_t i = 0; i < rounds; i++) {
+            r = lazy(a) + b - c + d;
+        }
+    }));
+    size_t const mul_rounds = rounds / 20;
+    report("r = a * d + c", nanoseconds_per_op(mul_rounds, [&] {
+        for (size_t i = 0; i < mul_rounds; i++) {
+            r = a * d + c;
+        }
+    }));
+    report("r = lazy(a) * d + c", nanoseconds_per_op(mul_rounds, [&] {
+        for (size_t i = 0; i < mul_rounds; i++) {
+            r = lazy(a) * d + c;
+        }
+    }));
+    sink = (r == 0);
+}
+
+template<size_t Bits, typename T>
+void bench_mul_add_chain(char const* name) {
+    std::vector<big_integer> seeds = random_values(1000, Bits / 32 - 1, Bits / 32 - 1);
+    std::vector<T> values;
+    for (big_integer const& seed : seeds) {
+        values.push_back(T(seed));
+    }
+    T const modulus = T(big_integer(1) << (Bits - 3)) - 1;
+    size_t const rounds = 100;
+    report(name, nanoseconds_per_op(rounds * values.size(), [&] {
+        T acc = 1;
+        for (size_t r = 0; r < rounds; r++) {
+            for (T const& v : values) {
+                acc = (acc * v + v) % modulus;
+            }
+        }
+        sink = (acc == 0);
+    }));
+}
+
+void bench_fixed_width() {
+    bench_mul_add_chain<256, big_integer>("(acc * v + v) % m, 256 bits, big_integer");
+    bench_mul_add_chain<256, fixed_big_integer<512>>("(acc * v + v) % m, 256 bits, fixed<512>");
+    bench_mul_add_chain<1024, big_integer>("(acc * v + v) % m, 1024 bits, big_integer");
+    bench_mul_add_chain<1024, fixed_big_integer<2048>>("(acc * v + v) % m, 1024 bits, fixed<2048>");
+}
+
+void bench_literals() {
+    size_t const rounds = 200000;
+    report("big_integer(\"<2^521 - 1>\")", nanoseconds_per_op(rounds, [] {
+        for (size_t i = 0; i < rounds; i++) {
+            big_integer p("6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454554977296311391480858037121987999716643812574028291115057151");
+            sink = (p == 0);
+        }
+    }));
+    report("<2^521 - 1>_bi", nanoseconds_per_op(rounds, [] {
+        for (size_t i = 0; i < rounds; i++) {
+            big_integer p = 6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454554977296311391480858037121987999716643812574028291115057151_bi;
+            sink = (p == 0);
+        }
+    }));
+}
+
+void bench_sum_distribution(size_t min_limbs, size_t max_limbs) {
+    std::vector<big_integer> values = random_values(1000000, min_limbs, max_limbs);
+    size_t const rounds = 5;
+    std::printf("%zu..%zu limbs\n", min_limbs, max_limbs);
+    report("acc += v[i]", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t r = 0; r < rounds; r++) {
+            big_integer acc;
+            for (big_integer const& v : values) {
+                acc += v;
+            }
+            sink = (acc == 0);
+        }
+    }));
+    report("sum(first, last)", nanoseconds_per_op(rounds * values.size(), [&values] {
+        for (size_t r = 0; r < rounds; r++) {
+            sink = (sum(values.begin(), values.end()) == 0);
+        }
+    }));
+}
+
+void bench_sum() {
+    bench_sum_distribution(1, 2);
+    bench_sum_distribution(4, 12);
+    bench_sum_distribution(20, 40);
+}
+
+void bench_product() {
+    std::vector<big_integer> values = random_values(20000, 1, 1);
+    report("std::accumulate(*), 20000 x 1 limb", nanoseconds_per_op(values.size(), [&values] {
+        big_integer acc = 1;
+        for (big_integer const& v : values) {
+            acc *= v;
+        }
+        sink = (acc == 0);
+    }));
+    report("product(first, last)", nanoseconds_per_op(values.size(), [&values] {
+        sink = (product(values.begin(), values.end()) == 0);
+    }));
+    report("product(first, last, 4 threads)", nanoseconds_per_op(values.size(), [&values] {
+        sink = (product(values.begin(), values.end(), 4) == 0);
+    }));
+}
+
+void bench_parallel() {
+    std::vector<big_integer> values = random_values(2000000, 1, 4);
+    report("sum(first, last), 2e6 x 1..4 limbs", nanoseconds_per_op(values.size(), [&values] {
+        sink = (sum(values.begin(), values.end()) == 0);
+    }));
+    for (size_t threads : {1, 2, 4, 8}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "parallel_sum, %zu threads", threads);
+        report(name, nanoseconds_per_op(values.size(), [&values, threads] {
+            sink = (parallel_sum(values, threads) == 0);
+        }));
+    }
+    values = random_values(100000, 1, 1);
+    for (size_t threads : {1, 2, 4, 8}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "parallel_product 1e5, %zu threads", threads);
+        report(name, nanoseconds_per_op(values.size(), [&values, threads] {
+            sink = (parallel_product(values, threads) == 0);
+        }));
+    }
+}
+
+void bench_bitwise_size(size_t limbs, size_t rounds) {
+    big_integer a = (big_integer(1) << static_cast<int>(32 * limbs - 1)) - 12345;
+    big_integer b = (big_integer(1) << static_cast<int>(32 * limbs - 7)) + 54321;
+    char name[64];
+    std::snprintf(name, sizeof(name), "a ^= b, %zu limbs, per limb", limbs);
+    report(name, nanoseconds_per_op(rounds * limbs, [&a, &b, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            a ^= b;
+        }
+    }));
+    std::snprintf(name, sizeof(name), "a &= b, %zu limbs, per limb", limbs);
+    report(name, nanoseconds_per_op(rounds * limbs, [&a, &b, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            a &= b;
+        }
+    }));
+    big_integer const mask = 0xffff;
+    std::snprintf(name, sizeof(name), "mask & a, %zu limbs", limbs);
+    report(name, nanoseconds_per_op(rounds, [&a, &mask, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            sink = ((mask & a) == 0);
+        }
+    }));
+    std::snprintf(name, sizeof(name), "~a, %zu limbs, per limb", limbs);
+    report(name, nanoseconds_per_op(rounds * limbs, [&a, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            sink = (~a == 0);
+        }
+    }));
+}
+
+void bench_bitwise() {
+    std::printf("kernels: %s\n", active_kernels());
+    bench_bitwise_size(1000, 100000);
+    bench_bitwise_size(4000000, 20);
+}
+
+void bench_arithmetic_size(size_t limbs, size_t rounds) {
+    big_integer a = (big_integer(1) << static_cast<int>(32 * limbs - 1)) / 3;
+    big_integer b = (big_integer(1) << static_cast<int>(32 * limbs - 5)) / 7;
+    char name[64];
+    std::snprintf(name, sizeof(name), "a += b, %zu limbs", limbs);
+    report(name, nanoseconds_per_op(rounds, [&a, &b, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            a += b;
+        }
+    }));
+    std::snprintf(name, sizeof(name), "a * b, %zu limbs", limbs);
+    report(name, nanoseconds_per_op(rounds, [&a, &b, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            sink = (a * b == 0);
+        }
+    }));
+}
+
+void bench_arithmetic() {
+    std::printf("kernels: %s\n", active_kernels());
+    bench_arithmetic_size(8, 1000000);
+    bench_arithmetic_size(30, 200000);
+    bench_arithmetic_size(1000, 2000);
+    bench_arithmetic_size(30000, 10);
+}
+
+void bench_shifts_size(size_t limbs, size_t rounds) {
+    big_integer a = -((big_integer(1) << static_cast<int>(32 * limbs - 1)) / 3);
+    char name[64];
+    std::snprintf(name, sizeof(name), "a <<= 45, a >>= 45, %zu limbs", limbs);
+    report(name, nanoseconds_per_op(rounds, [&a, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            a <<= 45;
+            a >>= 45;
+        }
+    }));
+    std::snprintf(name, sizeof(name), "a >> 77 (shared), %zu limbs", limbs);
+    report(name, nanoseconds_per_op(rounds, [&a, rounds] {
+        for (size_t i = 0; i < rounds; i++) {
+            sink = ((a >> 77) == 0);
+        }
+    }));
+}
+
+void bench_shifts() {
+    bench_shifts_size(4, 1000000);
+    bench_shifts_size(1000, 20000);
+    bench_shifts_size(100000, 200);
+}
+
+void bench_factorial_of(uint32_t n) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "factorial(%u)", n);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (factorial(n) == 0);
+    }));
+    std::snprintf(name, sizeof(name), "mpz_fac_ui(%u)", n);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (big_integer_gmp::factorial(n) == 0);
+    }));
+    std::snprintf(name, sizeof(name), "binomial(%u, %u)", n, n / 3);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (binomial(n, n / 3) == 0);
+    }));
+    std::snprintf(name, sizeof(name), "mpz_bin_uiui(%u, %u)", n, n / 3);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (big_integer_gmp::binomial(n, n / 3) == 0);
+    }));
+    std::snprintf(name, sizeof(name), "primorial(%u)", n);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (primorial(n) == 0);
+    }));
+    std::snprintf(name, sizeof(name), "mpz_primorial_ui(%u)", n);
+    report(name, nanoseconds_per_op(1, [n] {
+        sink = (big_integer_gmp::primorial(n) == 0);
+    }));
+}
+
+void bench_factorial() {
+    bench_factorial_of(100000);
+    bench_factorial_of(1000000);
+}
+
+struct counting_heap_allocator : heap_allocator {
+    size_t in_use = 0;
+
+    void* allocate(size_t& bytes) override {
+        in_use += bytes;
+        return heap_allocator::allocate(bytes);
+    }
+
+    void deallocate(void* ptr, size_t bytes) override {
+        in_use -= bytes;
+        heap_allocator::deallocate(ptr, bytes);
+    }
+};
+
+void bench_footprint_distribution(size_t min_limbs, size_t max_limbs) {
+    size_t const count = 1000000;
+    counting_heap_allocator heap;
+    limb_allocator::set_global(&heap);
+    {
+        std::vector<big_integer> values = random_values(count, min_limbs, max_limbs);
+        values.shrink_to_fit();
+        size_t inline_bytes = values.capacity() * sizeof(big_integer);
+        std::printf("%zu..%zu limbs: %zu MiB inline + %zu MiB heap, %.1f bytes/number\n",
+                    min_limbs, max_limbs, inline_bytes >> 20u, heap.in_use >> 20u,
+                    static_cast<double>(inline_bytes + heap.in_use) / static_cast<double>(count));
+        report("sum of vector", nanoseconds_per_op(values.size(), [&values] {
+            big_integer sum;
+            for (big_integer const& v : values) {
+                sum += v;
+            }
+            sink = (sum == 0);
+        }));
+    }
+    limb_allocator::set_global(nullptr);
+}
+
+void bench_footprint() {
+    std::printf("inline limbs: %zu, sizeof(big_integer): %zu\n", storage::SMALL_SIZE, sizeof(big_integer));
+    bench_footprint_distribution(1, 2);
+    bench_footprint_distribution(2, 4);
+    bench_footprint_distribution(4, 12);
+}
+
+struct benchmark {
+    char const* name;
+    void (*run)();
+};
+
+benchmark const BENCHMARKS[] = {
+    {"ref_counter", bench_ref_counter},
+    {"allocator", bench_allocator},
+    {"arena", bench_arena},
+    {"inline_limbs", bench_inline_limbs},
+    {"small_values", bench_small_values},
+    {"footprint", bench_footprint},
+    {"expressions", bench_expressions},
+    {"accumulate", bench_accumulate},
+    {"fixed_width", bench_fixed_width},
+    {"literals", bench_literals},
+    {"sum", bench_sum},
+    {"product", bench_product},
+    {"parallel", bench_parallel},
+    {"bitwise", bench_bitwise},
+    {"arithmetic", bench_arithmetic},
+    {"shifts", bench_shifts},
+    {"factorial", bench_factorial},
+};
+}
+
+int main(int argc, char** argv) {
+    for (benchmark const& bench : BENCHMARKS) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; i++) {
+            selected |= (std::strcmp(argv[i], bench.name) == 0);
+        }
+        if (selected) {
+            std::printf("== %s\n", bench.name);
+            bench.run();
+        }
+    }
+    return 0;
+}
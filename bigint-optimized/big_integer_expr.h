@@ -0,0 +1,162 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_BIG_INTEGER_EXPR_H
+#define BIGINT_BIG_INTEGER_EXPR_H
+
+#include "big_integer.h"
+#include <cstddef>
+
+// Opt-in expression templates. lazy(a) + b - c builds a chain of terms that
+// is evaluated by a single carry pass, lazy(x) * y + z becomes one
+// multiply-add. An expression is turned into a big_integer by conversion:
+//
+//     big_integer r = lazy(a) + b - c;
+//
+// Nodes only point at their operands, so an expression has to be consumed
+// within the full-expression that built it and must not be kept in `auto`.
+struct big_integer_expr {
+    static big_integer sum(big_integer const* const* terms, bool const* negated, size_t count) {
+        return big_integer::signed_sum(terms, negated, count);
+    }
+
+    static big_integer multiply_add(big_integer const& a, big_integer const& b, big_integer const& c, bool subtract) {
+        return big_integer::multiply_add(a, b, c, subtract);
+    }
+};
+
+template<size_t N>
+struct expr_sum {
+    big_integer const* terms[N];
+    bool negated[N];
+
+    operator big_integer() const {
+        return big_integer_expr::sum(terms, negated, N);
+    }
+};
+
+struct expr_product {
+    big_integer const* lhs;
+    big_integer const* rhs;
+
+    operator big_integer() const {
+        return *lhs * *rhs;
+    }
+};
+
+struct expr_addmul {
+    big_integer const* lhs;
+    big_integer const* rhs;
+    big_integer const* addend;
+    bool subtract;
+
+    operator big_integer() const {
+        return big_integer_expr::multiply_add(*lhs, *rhs, *addend, subtract);
+    }
+};
+
+inline expr_sum<1> lazy(big_integer const& a) {
+    expr_sum<1> res;
+    res.terms[0] = &a;
+    res.negated[0] = false;
+    return res;
+}
+
+template<size_t N, size_t M>
+expr_sum<N + M> concat(expr_sum<N> const& a, expr_sum<M> const& b, bool negate_b) {
+    expr_sum<N + M> res;
+    for (size_t i = 0; i < N; i++) {
+        res.terms[i] = a.terms[i];
+        res.negated[i] = a.negated[i];
+    }
+    for (size_t i = 0; i < M; i++) {
+        res.terms[N + i] = b.terms[i];
+        res.negated[N + i] = (b.negated[i] != negate_b);
+    }
+    return res;
+}
+
+template<size_t N, size_t M>
+expr_sum<N + M> operator+(expr_sum<N> const& a, expr_sum<M> const& b) {
+    return concat(a, b, false);
+}
+
+template<size_t N, size_t M>
+expr_sum<N + M> operator-(expr_sum<N> const& a, expr_sum<M> const& b) {
+    return concat(a, b, true);
+}
+
+// the rvalue overloads keep big_integer's own operator+(big_integer&&,
+// big_integer&&) from competing when the right operand is a temporary
+template<size_t N>
+expr_sum<N + 1> operator+(expr_sum<N> const& a, big_integer const& b) {
+    return concat(a, lazy(b), false);
+}
+
+template<size_t N>
+expr_sum<N + 1> operator+(expr_sum<N> const& a, big_integer&& b) {
+    return concat(a, lazy(b), false);
+}
+
+template<size_t N>
+expr_sum<N + 1> operator+(big_integer const& a, expr_sum<N> const& b) {
+    return concat(lazy(a), b, false);
+}
+
+template<size_t N>
+expr_sum<N + 1> operator+(big_integer&& a, expr_sum<N> const& b) {
+    return concat(lazy(a), b, false);
+}
+
+template<size_t N>
+expr_sum<N + 1> operator-(expr_sum<N> const& a, big_integer const& b) {
+    return concat(a, lazy(b), true);
+}
+
+template<size_t N>
+expr_sum<N + 1> operator-(big_integer const& a, expr_sum<N> const& b) {
+    return concat(lazy(a), b, true);
+}
+
+inline expr_product operator*(expr_sum<1> const& a, big_integer const& b) {
+    expr_product res;
+    res.lhs = a.terms[0];
+    res.rhs = &b;
+    return res;
+}
+
+inline expr_product operator*(expr_sum<1> const& a, big_integer&& b) {
+    return a * static_cast<big_integer const&>(b);
+}
+
+inline expr_addmul addmul(expr_product const& p, big_integer const& c, bool subtract) {
+    expr_addmul res;
+    res.lhs = p.lhs;
+    res.rhs = p.rhs;
+    res.addend = &c;
+    res.subtract = subtract;
+    return res;
+}
+
+inline expr_addmul operator+(expr_product const& p, big_integer const& c) {
+    return addmul(p, c, false);
+}
+
+inline expr_addmul operator+(expr_product const& p, big_integer&& c) {
+    return addmul(p, c, false);
+}
+
+inline expr_addmul operator+(big_integer const& c, expr_product const& p) {
+    return addmul(p, c, false);
+}
+
+inline expr_addmul operator+(big_integer&& c, expr_product const& p) {
+    return addmul(p, c, false);
+}
+
+inline expr_addmul operator-(expr_product const& p, big_integer const& c) {
+    return addmul(p, c, true);
+}
+
+#endif //BIGINT_BIG_INTEGER_EXPR_H
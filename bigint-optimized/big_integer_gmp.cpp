@@ -71,6 +71,24 @@ big_integer_gmp& big_integer_gmp::operator^=(big_integer_gmp const& rhs) {
   return *this;
 }
 
+big_integer_gmp big_integer_gmp::factorial(unsigned long n) {
+  big_integer_gmp res;
+  mpz_fac_ui(res.mpz, n);
+  return res;
+}
+
+big_integer_gmp big_integer_gmp::binomial(unsigned long n, unsigned long k) {
+  big_integer_gmp res;
+  mpz_bin_uiui(res.mpz, n, k);
+  return res;
+}
+
+big_integer_gmp big_integer_gmp::primorial(unsigned long n) {
+  big_integer_gmp res;
+  mpz_primorial_ui(res.mpz, n);
+  return res;
+}
+
 big_integer_gmp& big_integer_gmp::operator<<=(int rhs) {
   mpz_mul_2exp(mpz, mpz, rhs);
   return *this;
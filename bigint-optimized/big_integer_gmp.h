@@ -26,6 +26,10 @@ struct big_integer_gmp {
 
   ~big_integer_gmp();
 
+  static big_integer_gmp factorial(unsigned long n);
+  static big_integer_gmp binomial(unsigned long n, unsigned long k);
+  static big_integer_gmp primorial(unsigned long n);
+
   big_integer_gmp& operator=(big_integer_gmp const& other);
 
   big_integer_gmp& operator+=(big_integer_gmp const& rhs);
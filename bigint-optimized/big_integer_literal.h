@@ -0,0 +1,99 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_BIG_INTEGER_LITERAL_H
+#define BIGINT_BIG_INTEGER_LITERAL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "big_integer.h"
+
+// Digits of a _bi literal are turned into limbs by the compiler, at run time
+// a literal only copies its limbs into a fresh big_integer:
+//
+//     big_integer const p = 170141183460469231731687303715884105727_bi;
+//
+// Decimal, 0x hexadecimal, 0b binary and 0 octal forms are accepted, as
+// are digit separators.
+template<char... Chars>
+struct big_integer_literal {
+    static constexpr char CHARS[] = {Chars...};
+    static constexpr size_t COUNT = sizeof...(Chars);
+
+    static constexpr uint32_t base() {
+        if (COUNT >= 2 && CHARS[0] == '0' && (CHARS[1] == 'x' || CHARS[1] == 'X')) {
+            return 16;
+        }
+        if (COUNT >= 2 && CHARS[0] == '0' && (CHARS[1] == 'b' || CHARS[1] == 'B')) {
+            return 2;
+        }
+        return (COUNT >= 2 && CHARS[0] == '0' ? 8 : 10);
+    }
+
+    static constexpr size_t prefix() {
+        return (base() == 16 || base() == 2 ? 2 : 0);
+    }
+
+    static constexpr uint32_t digit(char c) {
+        if (c >= '0' && c <= '9') {
+            return static_cast<uint32_t>(c - '0');
+        }
+        if (c >= 'a' && c <= 'f') {
+            return static_cast<uint32_t>(c - 'a' + 10);
+        }
+        return static_cast<uint32_t>(c >= 'A' && c <= 'F' ? c - 'A' + 10 : 16);
+    }
+
+    static constexpr bool valid() {
+        for (size_t i = prefix(); i < COUNT; i++) {
+            if (CHARS[i] != '\'' && digit(CHARS[i]) >= base()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // every digit carries at most four bits
+    static constexpr size_t LIMBS = COUNT / 8 + 1;
+    typedef std::array<uint32_t, LIMBS> limb_array;
+
+    static constexpr limb_array parse() {
+        limb_array res{};
+        for (size_t i = prefix(); i < COUNT; i++) {
+            if (CHARS[i] == '\'') {
+                continue;
+            }
+            uint64_t carry = digit(CHARS[i]);
+            for (size_t j = 0; j < LIMBS; j++) {
+                uint64_t cur = static_cast<uint64_t>(res[j]) * base() + carry;
+                res[j] = static_cast<uint32_t>(cur);
+                carry = (cur >> 32u);
+            }
+        }
+        return res;
+    }
+
+    static constexpr size_t significant_size(limb_array const& limbs) {
+        size_t n = LIMBS;
+        while (n > 0 && limbs[n - 1] == 0) {
+            n--;
+        }
+        return n;
+    }
+
+    static big_integer value() {
+        static_assert(valid(), "invalid digit in a big_integer literal");
+        static constexpr limb_array limbs = parse();
+        static constexpr size_t size = significant_size(limbs);
+        return big_integer::from_limbs(limbs.data(), size);
+    }
+};
+
+template<char... Chars>
+big_integer operator""_bi() {
+    return big_integer_literal<Chars...>::value();
+}
+
+#endif //BIGINT_BIG_INTEGER_LITERAL_H
@@ -1,13 +1,28 @@
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <iomanip>
 #include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <utility>
 #include <gtest/gtest.h>
 
+#include "arena_scope.h"
 #include "big_integer.h"
+#include "big_integer_algorithm.h"
+#include "big_integer_expr.h"
 #include "big_integer_gmp.h"
+#include "big_integer_literal.h"
+#include "fixed_big_integer.h"
+#include "limb_allocator.h"
+#include "limb_kernels.h"
+#include "power_cache.h"
+#include "storage.h"
 
 TEST(correctness, two_plus_two) {
   EXPECT_EQ(big_integer(4), big_integer(2) + big_integer(2));
@@ -76,6 +91,37 @@ TEST(correctness, assignment_return_value) {
   EXPECT_TRUE(b == 7);
 }
 
+TEST(correctness, move_ctor) {
+  static_assert(std::is_nothrow_move_constructible<big_integer>::value, "move ctor must be noexcept");
+  static_assert(std::is_nothrow_move_assignable<big_integer>::value, "move assignment must be noexcept");
+
+  big_integer a("123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890");
+  big_integer b = std::move(a);
+  EXPECT_EQ(big_integer("123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890"), b);
+  EXPECT_EQ(0, a);
+
+  a = std::move(b);
+  a = std::move(a);
+  EXPECT_EQ(big_integer("123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890"), a);
+  b = -7;
+  a = std::move(b);
+  EXPECT_EQ(-7, a);
+}
+
+TEST(correctness, rvalue_operators) {
+  big_integer a("-3402823669209384634633746074317682114563402823669209384634633746074317682114561");
+  big_integer b("1844674407370955161718446744073709551617184467440737095516171844674407370955161");
+
+  big_integer shared = b;
+  EXPECT_EQ(a + b, std::move(shared) + big_integer(a));
+  shared = b;
+  EXPECT_EQ(a * b, big_integer(a) * std::move(shared));
+  EXPECT_EQ(a & b, big_integer(a) & big_integer(b));
+  EXPECT_EQ(a | b, big_integer(a) | big_integer(b));
+  EXPECT_EQ(a ^ b, big_integer(a) ^ big_integer(b));
+  EXPECT_EQ(big_integer("1844674407370955161718446744073709551617184467440737095516171844674407370955161"), b);
+}
+
 TEST(correctness, comparisons) {
   big_integer a = 100;
   big_integer b = 100;
@@ -100,6 +146,18 @@ TEST(correctness, compare_zero_and_minus_zero) {
   EXPECT_TRUE(a == b);
 }
 
+TEST(correctness, compare_negative_different_lengths) {
+  big_integer a = -(big_integer(1) << 100);
+  big_integer b = -1;
+
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(a <= b);
+  EXPECT_FALSE(b <= a);
+  EXPECT_TRUE(b > a);
+  EXPECT_TRUE(b >= a);
+  EXPECT_FALSE(a > b);
+}
+
 TEST(correctness, add) {
   big_integer a = 5;
   big_integer b = 20;
@@ -241,6 +299,24 @@ TEST(correctness, div_rounding_negative) {
   EXPECT_TRUE(c % d == -3);
 }
 
+TEST(correctness, div_small_top_limb) {
+  std::vector<big_integer> divisors = {(big_integer(1) << 64) + 1, (big_integer(1) << 65) - 1,
+                                       (big_integer(1) << 96) + (big_integer(1) << 32) + 1,
+                                       (big_integer(3) << 94) - 7, (big_integer(1) << 127) - 1};
+  std::vector<big_integer> dividends = {(big_integer(1) << 300) - 1, big_integer(1) << 256,
+                                        (big_integer(1) << 191) + 12345, (big_integer(1) << 128) - 1};
+  for (big_integer const& b : divisors) {
+    for (big_integer const& a : dividends) {
+      big_integer q = a / b;
+      big_integer r = a % b;
+      EXPECT_TRUE(r >= 0);
+      EXPECT_TRUE(r < b);
+      EXPECT_EQ(a, q * b + r);
+      EXPECT_EQ(-q, -a / b);
+    }
+  }
+}
+
 TEST(correctness, div_return_value) {
   big_integer a = 100;
   big_integer b = 2;
@@ -382,6 +458,15 @@ TEST(correctness, not_) {
   EXPECT_TRUE(~a == (-a - 1));
 }
 
+TEST(correctness, and_longer_lhs) {
+  big_integer a = (big_integer(1) << 100) - 1;
+
+  EXPECT_EQ(1, a & 1);
+  EXPECT_EQ(-1, a | -1);
+  EXPECT_EQ(-a - 1, a ^ -1);
+  EXPECT_EQ(a, a & -1);
+}
+
 TEST(correctness, shl_) {
   big_integer a = 23;
 
@@ -422,6 +507,30 @@ TEST(correctness, shr_signed) {
   EXPECT_EQ(-155, a);
 }
 
+TEST(correctness, shr_signed_exact) {
+  big_integer a = -8;
+  big_integer big = -(big_integer(1) << 100);
+
+  EXPECT_EQ(-1, a >> 3);
+  EXPECT_EQ(-1, a >> 100);
+  EXPECT_EQ(-1, big >> 100);
+  EXPECT_EQ(-2, big >> 99);
+  EXPECT_EQ(-(big_integer(1) << 36), big >> 64);
+  EXPECT_EQ(0, big_integer(7) >> 3);
+}
+
+TEST(correctness, shifts_keep_shared_value) {
+  big_integer a(std::string(100, '9'));
+  big_integer b = a, c = a;
+  b <<= 45;
+  c >>= 45;
+  EXPECT_EQ(a * (big_integer(1) << 45), b);
+  EXPECT_EQ(a / (big_integer(1) << 45), c);
+  EXPECT_EQ(big_integer(std::string(100, '9')), a);
+  EXPECT_EQ(0, big_integer(0) << 1000);
+  EXPECT_EQ(-(big_integer(1) << 1000), big_integer(-1) << 1000);
+}
+
 TEST(correctness, shr_return_value) {
   big_integer a = 64;
 
@@ -559,6 +668,25 @@ TEST(correctness, shr_long) {
 
 }
 
+TEST(correctness, literals) {
+  EXPECT_EQ(0, 0_bi);
+  EXPECT_EQ(123456789, 123456789_bi);
+  EXPECT_EQ(big_integer("170141183460469231731687303715884105727"),
+            170141183460469231731687303715884105727_bi);
+  EXPECT_EQ((big_integer(1) << 127) - 1, 170141183460469231731687303715884105727_bi);
+  EXPECT_EQ(-big_integer("98765432109876543210987654321"), -98765432109876543210987654321_bi);
+  EXPECT_EQ((big_integer(1) << 64) - 1, 0xFFFF'FFFF'FFFF'FFFF_bi);
+  EXPECT_EQ((big_integer(1) << 100) + 0xabc, 0x10000000000000000000000abc_bi);
+  EXPECT_EQ(big_integer(1) << 70, 0b1'0000000000'0000000000'0000000000'0000000000'0000000000'0000000000'0000000000_bi);
+  EXPECT_EQ(511, 0777_bi);
+  EXPECT_EQ(big_integer(std::string(100, '9')),
+            9999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999999_bi);
+
+  static_assert(big_integer_literal<'4', '2'>::parse()[0] == 42, "parsed at compile time");
+  static_assert(big_integer_literal<'0', 'x', '1', '0', '0', '0', '0', '0', '0', '0', '0'>::parse()[1] == 1,
+                "second limb of 2^32");
+}
+
 TEST(correctness, string_conv) {
   EXPECT_EQ("100", to_string(big_integer("100")));
   EXPECT_EQ("100", to_string(big_integer("0100")));
@@ -576,6 +704,436 @@ TEST(correctness, string_conv) {
   EXPECT_EQ("-2147483649", to_string(lim));
 }
 
+TEST(correctness, stream_output) {
+  std::ostringstream out;
+  out << big_integer("-1000000000000000000000000000001") << ' ' << big_integer(0) << ' ' << big_integer(1000000000);
+  EXPECT_EQ("-1000000000000000000000000000001 0 1000000000", out.str());
+
+  std::ostringstream padded;
+  padded << std::setw(6) << big_integer(-42) << '|' << std::left << std::setw(5) << big_integer(7) << '|'
+         << std::internal << std::setfill('0') << std::setw(5) << big_integer(-3);
+  EXPECT_EQ("   -42|7    |-0003", padded.str());
+}
+
+TEST(correctness, stream_input) {
+  std::istringstream in("  123456789012345678901234567890 -0042 +7 -1000000000x");
+  big_integer a, b, c, d;
+  in >> a >> b >> c >> d;
+  EXPECT_EQ(big_integer("123456789012345678901234567890"), a);
+  EXPECT_EQ(-42, b);
+  EXPECT_EQ(7, c);
+  EXPECT_EQ(-1000000000, d);
+  EXPECT_TRUE(in.good());
+  EXPECT_EQ('x', in.get());
+
+  big_integer e = 5;
+  std::istringstream bad("-x");
+  bad >> e;
+  EXPECT_TRUE(bad.fail());
+  EXPECT_EQ(5, e);
+  bad.clear();
+  EXPECT_EQ('-', bad.get());
+
+  std::istringstream sign_only("+");
+  sign_only >> e;
+  EXPECT_TRUE(sign_only.fail());
+  EXPECT_FALSE(sign_only.eof());
+  sign_only.clear();
+  EXPECT_EQ('+', sign_only.get());
+}
+
+TEST(correctness, stream_output_blocks) {
+  for (int n : {8, 9, 10, 576, 577, 600, 5000}) {
+    big_integer power = 1;
+    for (int i = 0; i < n; ++i)
+      power *= 10;
+    for (big_integer const& x : {power, power - 1, -power, power + 1, power * (power - 1)}) {
+      std::ostringstream out;
+      out << x;
+      EXPECT_EQ(to_string(x), out.str());
+    }
+  }
+  big_integer big = (big_integer(1) << 3000) + 1;
+  std::string text = to_string(-big);
+  std::ostringstream padded;
+  padded << std::setw(static_cast<int>(text.size() + 3)) << -big << '|' << std::left
+         << std::setw(static_cast<int>(text.size() + 2)) << -big << '|';
+  EXPECT_EQ("   " + text + "|" + text + "  |", padded.str());
+}
+
+TEST(correctness, stream_roundtrip) {
+  std::string digits(20000, '7');
+  digits[0] = '-';
+  std::istringstream in(digits);
+  big_integer a;
+  in >> a;
+  EXPECT_TRUE(in.eof());
+  std::ostringstream out;
+  out << a;
+  EXPECT_EQ(digits, out.str());
+  EXPECT_EQ(big_integer(digits), a);
+}
+
+TEST(correctness, power_cache_values) {
+  EXPECT_EQ(big_integer(10), power_cache::power(10, 0));
+  EXPECT_EQ(big_integer(10000), power_cache::power(10, 2));
+  EXPECT_EQ(big_integer("10000000000000000"), power_cache::power(10, 4));
+  EXPECT_EQ(big_integer(1) << 64, power_cache::power(2, 6));
+
+  big_integer p = power_cache::power(3, 9);
+  p += 1;
+  EXPECT_EQ(big_integer("19323349832288915105454068722019581055401465761603328550184537628902466746415537000017939429786029354390082329294586119505153509101332940884098040478728639542560550133727399482778062322407372338121043399668242276591791504658985882995272436541441") + 1, p);
+  EXPECT_EQ(big_integer("19323349832288915105454068722019581055401465761603328550184537628902466746415537000017939429786029354390082329294586119505153509101332940884098040478728639542560550133727399482778062322407372338121043399668242276591791504658985882995272436541441"), power_cache::power(3, 9));
+}
+
+TEST(correctness, power_cache_limit) {
+  size_t limit = power_cache::memory_limit();
+  power_cache::set_memory_limit(power_cache::memory_usage());
+  size_t usage = power_cache::memory_usage();
+  EXPECT_EQ(big_integer(1) << 1024, power_cache::power(65536, 6));
+  EXPECT_EQ(usage, power_cache::memory_usage());
+  power_cache::set_memory_limit(limit);
+  power_cache::warm_up(65536, 128);
+  EXPECT_GT(power_cache::memory_usage(), usage);
+}
+
+TEST(correctness, string_conv_concurrent) {
+  std::string digits(30000, '3');
+  big_integer expected(digits);
+  std::vector<std::thread> threads;
+  std::vector<int> ok(4, 0);
+  for (size_t t = 0; t != ok.size(); ++t) {
+    threads.emplace_back([&digits, &expected, &ok, t] {
+      big_integer a(digits);
+      ok[t] = (a == expected && to_string(a) == digits);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  EXPECT_EQ(std::vector<int>(4, 1), ok);
+}
+
+#ifndef BIGINT_SINGLE_THREADED
+TEST(correctness, share_across_threads) {
+  big_integer shared("-123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890");
+  big_integer expected = shared;
+  std::vector<std::thread> threads;
+  std::vector<int> ok(4, 0);
+  for (size_t t = 0; t != ok.size(); ++t) {
+    big_integer copy = shared;
+    threads.emplace_back([copy, &expected, &ok, t]() mutable {
+      for (int i = 0; i != 1000; ++i) {
+        big_integer local = copy;
+        local += i;
+        copy = local - i;
+      }
+      ok[t] = (copy == expected);
+    });
+  }
+  for (std::thread& thread : threads)
+    thread.join();
+  EXPECT_EQ(std::vector<int>(4, 1), ok);
+  EXPECT_EQ(expected, shared);
+}
+#endif
+
+TEST(storage, reserve) {
+  storage s;
+  EXPECT_EQ(storage::SMALL_SIZE, s.capacity());
+  for (uint32_t i = 0; i != 5; ++i)
+    s.push_back(i);
+  s.reserve(100);
+  size_t capacity = s.capacity();
+  EXPECT_GE(capacity, 100u);
+  EXPECT_EQ(5u, s.size());
+
+  storage shared = s;
+  s.resize(100, 7);
+  s.resize(3);
+  s.resize(50, 9);
+  EXPECT_EQ(capacity, s.capacity());
+  EXPECT_EQ(50u, s.size());
+  EXPECT_EQ(2u, s[2]);
+  EXPECT_EQ(9u, s[3]);
+  EXPECT_EQ(5u, shared.size());
+  EXPECT_EQ(4u, shared[4]);
+
+  s.push_back(1);
+  s.reserve(10);
+  EXPECT_EQ(capacity, s.capacity());
+  EXPECT_EQ(51u, s.size());
+}
+
+TEST(storage, amortized_growth) {
+  storage s;
+  size_t reallocations = 0;
+  for (uint32_t i = 0; i != 10000; ++i) {
+    size_t capacity = s.capacity();
+    s.push_back(i);
+    reallocations += (capacity != s.capacity());
+  }
+  EXPECT_LE(reallocations, 12u);
+  EXPECT_EQ(9999u, s.back());
+}
+
+TEST(storage, packed_layout) {
+  size_t inline_bytes = std::max(sizeof(void*), storage::SMALL_SIZE * sizeof(uint32_t));
+  EXPECT_EQ(sizeof(size_t) + (inline_bytes + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t),
+            sizeof(storage));
+  EXPECT_EQ(sizeof(storage), sizeof(big_integer));
+  if (storage::SMALL_SIZE <= 6) {
+    EXPECT_LE(sizeof(big_integer), 32u);
+  }
+
+  storage s;
+  s.set_tag(true);
+  for (uint32_t i = 0; i != 3 * storage::SMALL_SIZE; ++i)
+    s.push_back(i);
+  EXPECT_TRUE(s.tag());
+  storage copy = s;
+  s.resize(1);
+  EXPECT_TRUE(copy.tag());
+  EXPECT_TRUE(s.tag());
+  EXPECT_EQ(3 * storage::SMALL_SIZE, copy.size());
+  s.set_tag(false);
+  EXPECT_FALSE(s.tag());
+  EXPECT_EQ(1u, s.size());
+}
+
+TEST(storage, shrink_keeps_sharing) {
+  storage s;
+  for (uint32_t i = 0; i != 3 * storage::SMALL_SIZE; ++i)
+    s.push_back(i);
+  storage copy = s;
+  s.resize(2);
+  EXPECT_TRUE(s.is_shared());
+  EXPECT_EQ(2u, s.size());
+  EXPECT_EQ(3 * storage::SMALL_SIZE, copy.size());
+  s.push_back(7);
+  EXPECT_FALSE(s.is_shared());
+  EXPECT_EQ(7u, s[2]);
+  EXPECT_EQ(2u, copy[2]);
+}
+
+TEST(correctness, unnormalized_limbs) {
+  big_integer big = big_integer(1) << 300;
+  big_integer one = big - (big - 1);
+  big_integer minus_one = (big - 1) - big;
+  EXPECT_EQ(1, one);
+  EXPECT_EQ(-1, minus_one);
+  EXPECT_EQ(0, one + minus_one);
+  EXPECT_TRUE(one < 2);
+  EXPECT_TRUE(minus_one < one);
+  EXPECT_TRUE(minus_one > -2);
+  EXPECT_EQ("1", to_string(one));
+  EXPECT_EQ("-1", to_string(minus_one));
+  EXPECT_EQ(big, big * one);
+  EXPECT_EQ(-big, big * minus_one);
+  EXPECT_EQ(big, big / one);
+  EXPECT_EQ(0, one / big);
+  EXPECT_EQ(1, one & 3);
+  EXPECT_EQ(-2, ~one);
+
+  big_integer acc = big;
+  for (int i = 0; i != 1000; ++i) {
+    acc += i;
+    acc -= big;
+    acc += big;
+  }
+  EXPECT_EQ(big + 999 * 500, acc);
+}
+
+TEST(correctness, sign_survives_moves) {
+  big_integer a = -(big_integer(1) << 300);
+  big_integer b = std::move(a);
+  EXPECT_EQ(0, a);
+  EXPECT_TRUE(b < 0);
+  std::vector<big_integer> v(3, big_integer(-5));
+  v.push_back(std::move(b));
+  v.resize(1000, big_integer(-7));
+  EXPECT_EQ(-5, v[0]);
+  EXPECT_EQ(-(big_integer(1) << 300), v[3]);
+  EXPECT_EQ(-7, v[999]);
+}
+
+namespace {
+struct counting_allocator : limb_allocator {
+  void* allocate(size_t& bytes) override {
+    ++allocated;
+    return ::operator new(bytes);
+  }
+
+  void deallocate(void* ptr, size_t) override {
+    ++deallocated;
+    ::operator delete(ptr);
+  }
+
+  size_t allocated = 0;
+  size_t deallocated = 0;
+};
+}
+
+TEST(allocator, custom_hook) {
+  counting_allocator counter;
+  limb_allocator::set_global(&counter);
+  {
+    big_integer a(std::string(200, '9'));
+    big_integer b = a * a - a;
+    EXPECT_EQ(a * (a - 1), b);
+  }
+  limb_allocator::set_global(nullptr);
+  EXPECT_GT(counter.allocated, 0u);
+  EXPECT_EQ(counter.allocated, counter.deallocated);
+}
+
+TEST(allocator, no_copy_on_read) {
+  big_integer a(std::string(200, '9'));
+  big_integer b = a;
+  counting_allocator counter;
+  limb_allocator::set_global(&counter);
+  b &= -1;
+  b |= 0;
+  b ^= 0;
+  EXPECT_TRUE(b == a && b <= a && !(b < a));
+  EXPECT_EQ(a, +b);
+  limb_allocator::set_global(nullptr);
+  EXPECT_EQ(0u, counter.allocated);
+  b += 1;
+  EXPECT_EQ(a + 1, b);
+  EXPECT_EQ(big_integer(std::string(200, '9')), a);
+}
+
+TEST(allocator, bitwise_without_extension) {
+  big_integer big(std::string(300, '9'));
+  big_integer negative = -big;
+  big_integer mask = 0xffff;
+  counting_allocator counter;
+  limb_allocator::set_global(&counter);
+  big_integer low = mask & big;
+  big_integer low_negative = mask & negative;
+  big_integer copy = big;
+  copy |= 0;
+  copy ^= 0;
+  big_integer small = mask;
+  small |= -1;
+  limb_allocator::set_global(nullptr);
+  EXPECT_EQ(0u, counter.allocated);
+  EXPECT_EQ(big % 65536, low);
+  EXPECT_EQ(65536 - big % 65536, low_negative);
+  EXPECT_EQ(big, copy);
+  EXPECT_EQ(-1, small);
+  EXPECT_EQ(big % 65536, big & mask);
+  EXPECT_EQ(big, mask | big);
+  EXPECT_EQ(~big, -1 ^ big);
+}
+
+namespace {
+// allocates from the pool once the pool's cache of its thread is destroyed:
+// a thread_local constructed before the first allocation is destroyed after it
+struct teardown_allocation {
+  teardown_allocation(size_t& bytes, void*& block, big_integer& value) : bytes(bytes), block(block), value(value) {}
+
+  ~teardown_allocation() {
+    bytes = 100;
+    block = pool_allocator::instance().allocate(bytes);
+    value = big_integer(std::string(300, '9'));
+  }
+
+  size_t& bytes;
+  void*& block;
+  big_integer& value;
+};
+}
+
+TEST(allocator, pool_block_from_thread_teardown) {
+  size_t bytes = 0;
+  void* block = nullptr;
+  big_integer value;
+  std::thread([&] {
+    thread_local teardown_allocation late(bytes, block, value);
+    big_integer warm(std::string(300, '1'));
+    warm *= warm;
+  }).join();
+  EXPECT_EQ(pool_allocator::MIN_BLOCK << 1, bytes);
+  pool_allocator::instance().deallocate(block, bytes);
+  size_t again = 100;
+  void* reused = pool_allocator::instance().allocate(again);
+  EXPECT_EQ(bytes, again);
+  std::memset(reused, 0, again);
+  pool_allocator::instance().deallocate(reused, again);
+  EXPECT_EQ(big_integer(std::string(300, '9')), value);
+  value = 0;
+  big_integer next(std::string(300, '8'));
+  next *= next;
+  EXPECT_EQ(big_integer(std::string(300, '8')) * big_integer(std::string(300, '8')), next);
+}
+
+TEST(allocator, pool_hit_rate) {
+  big_integer a(std::string(300, '7'));
+  big_integer m(std::string(150, '3'));
+  pool_allocator::instance().reset_stats();
+  for (int i = 0; i != 200; ++i) {
+    a = (a * 3 + i) % m;
+    EXPECT_FALSE(to_string(-a).empty());
+  }
+  pool_allocator::statistics stats = pool_allocator::instance().stats();
+  EXPECT_GT(stats.hits + stats.misses, 400u);
+  EXPECT_GT(stats.hit_rate(), 0.95);
+}
+
+TEST(allocator, arena_scope) {
+  big_integer a(std::string(120, '9')), b(std::string(110, '8')), c(std::string(100, '7'));
+  big_integer m(std::string(90, '5'));
+  big_integer expected = (a * b + c) % m;
+  big_integer result;
+  size_t used;
+  {
+    arena_scope arena(1024);
+    big_integer x = a;
+    for (int i = 0; i != 10; ++i)
+      x = (x * b + c) % m;
+    result = arena.escape((a * b + c) % m);
+    used = arena.bytes_used();
+    EXPECT_EQ(expected, result);
+  }
+  EXPECT_GT(used, 0u);
+  EXPECT_EQ(expected, result);
+  result += 1;
+  EXPECT_EQ(expected + 1, result);
+}
+
+TEST(allocator, arena_scope_nested) {
+  big_integer a(std::string(200, '3'));
+  big_integer outer_result;
+  {
+    arena_scope outer;
+    big_integer x = a * a;
+    {
+      arena_scope inner;
+      x = outer.escape(inner.escape(x * 2) + 1);
+    }
+    outer_result = outer.escape(x - 1);
+  }
+  EXPECT_EQ(a * a * 2, outer_result);
+}
+
+TEST(allocator, power_cache_outlives_arena) {
+  std::string digits(20000, '7');
+  {
+    arena_scope arena;
+    EXPECT_EQ(digits, to_string(big_integer(digits)));
+    EXPECT_EQ(big_integer(1) << 4096, power_cache::power(4, 11));
+  }
+  EXPECT_EQ(digits, to_string(big_integer(digits)));
+  EXPECT_EQ(big_integer(1) << 4096, power_cache::power(4, 11));
+  counting_allocator counter;
+  limb_allocator::set_global(&counter);
+  big_integer power = power_cache::power(8, 11);
+  limb_allocator::set_global(nullptr);
+  EXPECT_EQ(0u, counter.allocated);
+  EXPECT_EQ(big_integer(1) << 6144, power);
+}
+
 namespace {
 size_t const number_of_iterations = 10;
 size_t const max_size = 2048;
@@ -689,6 +1247,29 @@ TEST(correctness, div_randomized) {
   }
 }
 
+TEST(correctness, word_boundaries) {
+  std::vector<std::string> values = {"0", "1", "-1", "2147483647", "-2147483648", "2147483648", "4294967295",
+                                     "4294967296", "-4294967296", "-4294967297", "9223372036854775807",
+                                     "-9223372036854775808", "9223372036854775808", "-9223372036854775809",
+                                     "3037000499", "-3037000500", "18446744073709551616", "-18446744073709551615"};
+  for (std::string const& x : values) {
+    for (std::string const& y : values) {
+      big_integer a(x), b(y);
+      big_integer_gmp ga(x), gb(y);
+      EXPECT_EQ(to_string(ga + gb), to_string(a + b));
+      EXPECT_EQ(to_string(ga - gb), to_string(a - b));
+      EXPECT_EQ(to_string(ga * gb), to_string(a * b));
+      EXPECT_EQ(ga < gb, a < b);
+      EXPECT_EQ(ga == gb, a == b);
+      EXPECT_EQ(to_string(-ga), to_string(-a));
+      if (y != "0") {
+        EXPECT_EQ(to_string(ga / gb), to_string(a / b));
+        EXPECT_EQ(to_string(ga % gb), to_string(a % b));
+      }
+    }
+  }
+}
+
 // y2019 tests
 
 TEST(correctness_random, cmp) {
@@ -743,6 +1324,210 @@ TEST(correctness_random, mul) {
   }
 }
 
+TEST(correctness_random, expression_chains) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b, c, d;
+    a.random(max_size, rng);
+    b.random(max_size / 2, rng);
+    c.random(max_size, rng);
+    d.random(32, rng);
+    big_integer A(to_string(a)), B(to_string(b)), C(to_string(c)), D(to_string(d));
+
+    big_integer R = lazy(A) + B - C + D;
+    EXPECT_EQ(to_string(a + b - c + d), to_string(R));
+    R = lazy(A) - C - B;
+    EXPECT_EQ(to_string(a - c - b), to_string(R));
+    R = A - (lazy(B) - C);
+    EXPECT_EQ(to_string(a - (b - c)), to_string(R));
+
+    R = lazy(A) * B + C;
+    EXPECT_EQ(to_string(a * b + c), to_string(R));
+    R = lazy(A) * B - C;
+    EXPECT_EQ(to_string(a * b - c), to_string(R));
+    R = D + lazy(C) * D;
+    EXPECT_EQ(to_string(d + c * d), to_string(R));
+  }
+}
+
+TEST(correctness, expression_operands) {
+  big_integer a = big_integer(1) << 100;
+  big_integer b = -a;
+  EXPECT_EQ(0, big_integer(lazy(a) + b));
+  EXPECT_EQ(-1, big_integer(lazy(b) + a - 1));
+  EXPECT_EQ(a * 2 + 5, big_integer(lazy(a) + a + big_integer(5)));
+  EXPECT_EQ(a * a - 1, big_integer(lazy(a) * a - 1));
+  EXPECT_EQ(-(a * a) + 7, big_integer(lazy(a) * b + 7));
+  EXPECT_EQ(6, big_integer(lazy(2) * 3 + 0));
+  EXPECT_EQ((big_integer(1) << 63) + 1, big_integer(lazy(big_integer(1) << 62) * 2 + 1));
+
+  a = lazy(a) + a + a;
+  EXPECT_EQ(3 * (big_integer(1) << 100), a);
+  a = lazy(a) * a + a;
+  EXPECT_EQ(9 * (big_integer(1) << 200) + 3 * (big_integer(1) << 100), a);
+}
+
+TEST(correctness_random, sum) {
+  std::default_random_engine rng(42);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    std::vector<big_integer> terms;
+    big_integer_gmp expected = 0;
+    for (size_t i = 0; i != 200; ++i) {
+      big_integer_gmp x;
+      x.random(1 + rng() % (i % 10 == 0 ? max_size : 96), rng);
+      expected += x;
+      terms.push_back(big_integer(to_string(x)));
+    }
+    EXPECT_EQ(to_string(expected), to_string(sum(terms.begin(), terms.end())));
+  }
+}
+
+TEST(correctness_random, product) {
+  std::default_random_engine rng(43);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    std::vector<big_integer> factors;
+    big_integer_gmp expected = 1;
+    for (size_t i = 0; i != 300; ++i) {
+      big_integer_gmp x;
+      x.random(1 + rng() % 200, rng);
+      expected *= x;
+      factors.push_back(big_integer(to_string(x)));
+    }
+    EXPECT_EQ(to_string(expected), to_string(product(factors.begin(), factors.end())));
+    EXPECT_EQ(to_string(expected), to_string(product(factors.begin(), factors.end(), 4)));
+  }
+}
+
+TEST(correctness, product_tree) {
+  std::vector<big_integer> empty;
+  EXPECT_EQ(1, product(empty.begin(), empty.end()));
+  std::vector<int> small = {-2, 3, -5, 7};
+  EXPECT_EQ(210, product(small.begin(), small.end()));
+  std::vector<big_integer> twos(1000, big_integer(2));
+  EXPECT_EQ(big_integer(1) << 1000, product(twos.begin(), twos.end(), 3));
+  EXPECT_EQ(big_integer(1) << 1000, product_tree(twos.data(), twos.size(), 16));
+}
+
+TEST(correctness_random, parallel_reduction) {
+  std::default_random_engine rng(45);
+  std::vector<big_integer> values;
+  big_integer_gmp expected_sum = 0, expected_product = 1;
+  for (size_t i = 0; i != 10000; ++i) {
+    int x = static_cast<int>(rng() % 2000000) - 999999;
+    expected_sum += x;
+    expected_product *= x;
+    values.push_back(x);
+  }
+  big_integer sum(to_string(expected_sum)), product(to_string(expected_product));
+  for (size_t threads : {1, 2, 3, 8, 0}) {
+    EXPECT_EQ(sum, parallel_sum(values, threads));
+    EXPECT_EQ(product, parallel_product(values, threads));
+  }
+}
+
+TEST(correctness, parallel_reduction) {
+  std::vector<big_integer> values;
+  EXPECT_EQ(0, parallel_sum(values, 4));
+  EXPECT_EQ(1, parallel_product(values, 4));
+  values.assign(5000, big_integer(-3));
+  EXPECT_EQ(-15000, parallel_sum(values, 4));
+  values.assign(5000, big_integer(2));
+  EXPECT_EQ(big_integer(1) << 5000, parallel_product(values, 4));
+}
+
+TEST(correctness, factorial) {
+  EXPECT_EQ(1, factorial(0));
+  EXPECT_EQ(1, factorial(1));
+  EXPECT_EQ(3628800, factorial(10));
+  for (uint32_t n : {2u, 13u, 100u, 1000u, 4321u}) {
+    EXPECT_EQ(to_string(big_integer_gmp::factorial(n)), to_string(factorial(n)));
+  }
+}
+
+TEST(correctness, binomial) {
+  EXPECT_EQ(0, binomial(3, 4));
+  EXPECT_EQ(1, binomial(0, 0));
+  EXPECT_EQ(252, binomial(10, 5));
+  for (uint32_t n : {1u, 50u, 999u, 3000u}) {
+    for (uint32_t k : {0u, 1u, n / 7, n / 2, n}) {
+      EXPECT_EQ(to_string(big_integer_gmp::binomial(n, k)), to_string(binomial(n, k)));
+    }
+  }
+}
+
+TEST(correctness, binomial_above_int_max) {
+  uint32_t n = 2147483659u;
+  big_integer big_n = (big_integer(1) << 31) + 11;
+  EXPECT_EQ(big_n, binomial(n, 1));
+  EXPECT_EQ(big_n, binomial(n, n - 1));
+  EXPECT_EQ(big_n * (big_n - 1) / 2, binomial(n, 2));
+  EXPECT_EQ((big_integer(1) << 32) - 1, binomial(UINT32_MAX, 1));
+  for (uint32_t k : {3u, 17u, 1000u}) {
+    EXPECT_EQ(to_string(big_integer_gmp::binomial(UINT32_MAX, k)), to_string(binomial(UINT32_MAX, k)));
+    EXPECT_EQ(to_string(big_integer_gmp::binomial(n, k)), to_string(binomial(n, n - k)));
+  }
+}
+
+TEST(correctness, primorial) {
+  EXPECT_EQ(1, primorial(1));
+  EXPECT_EQ(30030, primorial(16));
+  EXPECT_EQ(to_string(big_integer_gmp::primorial(5000)), to_string(primorial(5000)));
+}
+
+TEST(correctness_random, stream_output) {
+  std::default_random_engine rng(26);
+  for (size_t itn = 0; itn != 5 * number_of_iterations; ++itn) {
+    big_integer_gmp x;
+    x.random(1 + rng() % 20000, rng);
+    std::ostringstream out;
+    out << big_integer(to_string(x));
+    EXPECT_EQ(to_string(x), out.str());
+  }
+}
+
+TEST(correctness_random, square) {
+  std::default_random_engine rng(44);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp x;
+    x.random(1 + rng() % 5000, rng);
+    big_integer a(to_string(x));
+    a *= a;
+    EXPECT_EQ(to_string(x * x), to_string(a));
+  }
+}
+
+TEST(correctness, sum_accumulator) {
+  std::vector<big_integer> empty;
+  EXPECT_EQ(0, sum(empty.begin(), empty.end()));
+
+  big_integer big = big_integer(1) << 1000;
+  sum_accumulator acc;
+  acc += big;
+  acc += -big;
+  acc += -1;
+  EXPECT_EQ(-1, acc.result());
+  for (int i = 0; i != 1000; ++i)
+    acc += -big;
+  EXPECT_EQ(-1000 * big - 1, acc.result());
+  acc.clear();
+  EXPECT_EQ(0, acc.result());
+  for (int i = 0; i != 1000; ++i)
+    acc += -1;
+  EXPECT_EQ(-1000, acc.result());
+}
+
+TEST(correctness_random, mul_large) {
+  std::default_random_engine rng(7);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b;
+    a.random(1000 + rng() % (20 * max_size), rng);
+    b.random(itn % 2 == 0 ? 1000 + rng() % (20 * max_size) : 1000 + rng() % max_size, rng);
+    big_integer A(to_string(a)), B(to_string(b));
+    EXPECT_EQ(to_string(a * b), to_string(A * B));
+    EXPECT_EQ(to_string(a * a), to_string(A * A));
+  }
+}
+
 TEST(correctness_random, div) {
   std::default_random_engine rng(322);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -759,6 +1544,20 @@ TEST(correctness_random, div) {
   }
 }
 
+TEST(correctness_random, div_unnormalized_divisor) {
+  std::default_random_engine rng(2020);
+  for (size_t itn = 0; itn != 20 * number_of_iterations; ++itn) {
+    big_integer_gmp a, b;
+    a.random(64 + rng() % max_size, rng);
+    b.random(40 + rng() % (max_size / 4), rng);
+    if (itn % 4 == 0)
+      b = (big_integer_gmp(1) << static_cast<int>(40 + rng() % 400)) - 1;
+    big_integer A(to_string(a)), B(to_string(b));
+    EXPECT_EQ(to_string(a / b), to_string(A / B));
+    EXPECT_EQ(to_string(a % b), to_string(A % B));
+  }
+}
+
 TEST(correctness_random, mod) {
   std::default_random_engine rng(322);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -795,6 +1594,21 @@ TEST(correctness_random, bitwise) {
   }
 }
 
+TEST(correctness_random, bitwise_unequal_lengths) {
+  std::default_random_engine rng(46);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a, b;
+    a.random(1 + rng() % 2000, rng);
+    b.random(1 + rng() % 100, rng);
+    big_integer x(to_string(a)), y(to_string(b));
+    EXPECT_EQ(to_string(a & b), to_string(x & y));
+    EXPECT_EQ(to_string(a | b), to_string(x | y));
+    EXPECT_EQ(to_string(a ^ b), to_string(x ^ y));
+    EXPECT_EQ(to_string(b & a), to_string(y & x));
+    EXPECT_EQ(to_string(~a), to_string(~x));
+  }
+}
+
 TEST(correctness_random, bit_shifts) {
   std::default_random_engine rng(42);
   for (size_t itn = 0; itn != number_of_iterations; ++itn) {
@@ -808,6 +1622,21 @@ TEST(correctness_random, bit_shifts) {
   }
 }
 
+TEST(correctness_random, bit_shifts_exact) {
+  std::default_random_engine rng(50);
+  for (size_t itn = 0; itn != number_of_iterations; ++itn) {
+    big_integer_gmp a;
+    a.random(1 + rng() % 500, rng);
+    int low = static_cast<int>(rng() % 200);
+    a <<= low;
+    big_integer R(to_string(a));
+    for (int shift : {0, 1, low / 2, low, low + 1, low + 33}) {
+      EXPECT_EQ(to_string(a >> shift), to_string(R >> shift));
+      EXPECT_EQ(to_string(a << shift), to_string(R << shift));
+    }
+  }
+}
+
 // TODO: extend due to idea
 TEST(correctness_twos_complement, simple) {
   std::string a = "-36893488147419103232"; // -(1 << 65)
@@ -834,3 +1663,192 @@ TEST(correctness_twos_complement, all_ones) {
 
   EXPECT_EQ(to_string(gmp_ans), to_string(your_ans));
 }
+
+namespace {
+template<size_t Bits>
+big_integer_gmp wrap(big_integer_gmp const& x) {
+  big_integer_gmp modulus = big_integer_gmp(1) << static_cast<int>(Bits);
+  big_integer_gmp low = x & (modulus - 1);
+  return (low >= (modulus >> 1) ? low - modulus : low);
+}
+
+template<size_t Bits>
+void check_fixed_random(unsigned seed) {
+  typedef fixed_big_integer<Bits> fixed;
+  std::default_random_engine rng(seed);
+  for (size_t itn = 0; itn != 50 * number_of_iterations; ++itn) {
+    big_integer_gmp a, b, wide;
+    a.random(Bits - 1, rng);
+    b.random((itn % 2 == 0 ? Bits / 2 : Bits) - 1, rng);
+    wide.random(3 * Bits, rng);
+    if (b == 0)
+      b = 1;
+    fixed A(to_string(a)), B(to_string(b));
+    int shift = static_cast<int>(rng() % (Bits + 40));
+
+    EXPECT_EQ(to_string(a), to_string(A));
+    EXPECT_EQ(to_string(wrap<Bits>(wide)), to_string(fixed(big_integer(to_string(wide)))));
+    EXPECT_EQ(big_integer(to_string(b)), big_integer(B));
+    EXPECT_EQ(to_string(wrap<Bits>(a + b)), to_string(A + B));
+    EXPECT_EQ(to_string(wrap<Bits>(a - b)), to_string(A - B));
+    EXPECT_EQ(to_string(wrap<Bits>(a * b)), to_string(A * B));
+    EXPECT_EQ(to_string(wrap<Bits>(a / b)), to_string(A / B));
+    EXPECT_EQ(to_string(wrap<Bits>(a % b)), to_string(A % B));
+    EXPECT_EQ(to_string(wrap<Bits>(b / a)), to_string(B / A));
+    EXPECT_EQ(to_string(wrap<Bits>(b % a)), to_string(B % A));
+    EXPECT_EQ(to_string(a & b), to_string(A & B));
+    EXPECT_EQ(to_string(a | b), to_string(A | B));
+    EXPECT_EQ(to_string(a ^ b), to_string(A ^ B));
+    EXPECT_EQ(to_string(~a), to_string(~A));
+    EXPECT_EQ(to_string(wrap<Bits>(-a)), to_string(-A));
+    EXPECT_EQ(to_string(wrap<Bits>(a << shift)), to_string(A << shift));
+    EXPECT_EQ(to_string(a >> shift), to_string(A >> shift));
+    EXPECT_EQ(a < b, A < B);
+    EXPECT_EQ(a <= b, A <= B);
+    EXPECT_EQ(a == b, A == B);
+  }
+}
+}
+
+TEST(fixed_random, width_32) {
+  check_fixed_random<32>(1);
+}
+
+TEST(fixed_random, width_96) {
+  check_fixed_random<96>(2);
+}
+
+TEST(fixed_random, width_256) {
+  check_fixed_random<256>(3);
+}
+
+TEST(fixed_random, width_1024) {
+  check_fixed_random<1024>(4);
+}
+
+TEST(fixed, constexpr_api) {
+  typedef fixed_big_integer<256> u256;
+  constexpr u256 p = (u256(1) << 255) - 19;
+  constexpr u256 x = u256(123456789) * u256(987654321) * u256(-5);
+  static_assert(p > 0, "2^255 - 19 is positive in 256 bits");
+  static_assert((u256(1) << 256) == 0, "shifted out");
+  static_assert(x / u256(-5) == u256(123456789) * u256(987654321), "exact division");
+  static_assert(p % 1000 == 949, "2^255 - 19 ends with 949");
+  static_assert((-u256(7) >> 1) == -4, ">> rounds down");
+  static_assert(p.limbs()[0] == 0xFFFFFFEDu, "low limb of 2^255 - 19");
+  EXPECT_EQ((big_integer(1) << 255) - 19, big_integer(p));
+  EXPECT_EQ("-1", to_string(u256(-1)));
+  EXPECT_EQ(u256(-1), u256(-(big_integer(1) << 256) - 1));
+  EXPECT_EQ(u256(1) << 255, -(u256(1) << 255));
+  EXPECT_EQ(u256(1) << 255, (u256(1) << 255) / -1);
+  EXPECT_THROW(u256(1) / 0, std::runtime_error);
+}
+
+namespace {
+// limbs biased towards 0 and UINT32_MAX, so that carries run far
+std::vector<uint32_t> carry_heavy_limbs(size_t n, std::mt19937& rng) {
+  std::vector<uint32_t> res(n);
+  for (uint32_t& limb : res) {
+    uint32_t kind = rng() % 3;
+    limb = (kind == 0 ? 0 : kind == 1 ? UINT32_MAX : static_cast<uint32_t>(rng()));
+  }
+  return res;
+}
+}
+
+namespace {
+// ctest forces every variant through BIGINT_KERNELS; when the CPU cannot run
+// the forced one the run is reported as skipped rather than passing on the
+// fallback variant
+int const SKIP_RETURN_CODE = 77;
+
+struct forced_kernels_environment : ::testing::Environment {
+  void SetUp() override {
+    char const* forced = std::getenv("BIGINT_KERNELS");
+    std::vector<char const*> variants = kernel_variants();
+    bool known = forced != nullptr && std::any_of(variants.begin(), variants.end(), [forced](char const* name) {
+      return std::strcmp(name, forced) == 0;
+    });
+    if (known && !kernels_supported(forced)) {
+      std::printf("Skipped: this CPU cannot run BIGINT_KERNELS=%s\n", forced);
+      std::fflush(stdout);
+      std::_Exit(SKIP_RETURN_CODE);
+    }
+  }
+};
+
+::testing::Environment* const forced_kernels = ::testing::AddGlobalTestEnvironment(new forced_kernels_environment);
+}
+
+TEST(kernels, dispatch) {
+  std::vector<char const*> variants = kernel_variants();
+  ASSERT_FALSE(variants.empty());
+  EXPECT_STREQ("scalar", variants.back());
+  EXPECT_TRUE(kernels_supported("scalar"));
+  EXPECT_FALSE(kernels_supported("no-such-variant"));
+  EXPECT_TRUE(kernels_supported(active_kernels()));
+  char const* forced = std::getenv("BIGINT_KERNELS");
+  if (forced != nullptr) {
+    EXPECT_STREQ(forced, active_kernels()) << "BIGINT_KERNELS names no kernel variant";
+  } else {
+    for (char const* variant : variants) {
+      if (kernels_supported(variant)) {
+        EXPECT_STREQ(variant, active_kernels());
+        break;
+      }
+    }
+  }
+}
+
+TEST(kernels, arithmetic) {
+  std::mt19937 rng(47);
+  for (size_t n = 0; n != 24; ++n) {
+    std::vector<uint32_t> a = carry_heavy_limbs(n, rng), b = carry_heavy_limbs(n, rng);
+    uint32_t k = (n % 2 == 0 ? UINT32_MAX : static_cast<uint32_t>(rng()));
+
+    std::vector<uint32_t> sum(n), diff(n), prod(n), acc = b;
+    uint64_t carry = 0, borrow = 0, rem = 7, acc_rem = 0;
+    for (size_t i = 0; i != n; ++i) {
+      uint64_t cur = carry + a[i] + b[i];
+      sum[i] = static_cast<uint32_t>(cur);
+      carry = cur >> 32;
+      cur = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+      diff[i] = static_cast<uint32_t>(cur);
+      borrow = cur >> 63;
+      cur = static_cast<uint64_t>(a[i]) * k + rem;
+      prod[i] = static_cast<uint32_t>(cur);
+      rem = cur >> 32;
+      cur = static_cast<uint64_t>(a[i]) * k + acc[i] + acc_rem;
+      acc[i] = static_cast<uint32_t>(cur);
+      acc_rem = cur >> 32;
+    }
+
+    std::vector<uint32_t> out = a;
+    EXPECT_EQ(carry, add_n(out.data(), out.data(), b.data(), n));
+    EXPECT_EQ(sum, out);
+    out = a;
+    EXPECT_EQ(borrow, sub_n(out.data(), out.data(), b.data(), n));
+    EXPECT_EQ(diff, out);
+    out = a;
+    EXPECT_EQ(rem, mul_1(out.data(), out.data(), n, k, 7));
+    EXPECT_EQ(prod, out);
+    out = b;
+    EXPECT_EQ(acc_rem, addmul_1(out.data(), a.data(), n, k));
+    EXPECT_EQ(acc, out);
+
+    for (size_t m = 1; m <= n; ++m) {
+      std::vector<uint32_t> expected(n + m, 0), res(n + m, 0);
+      for (size_t j = 0; j != m; ++j) {
+        uint64_t row = 0;
+        for (size_t i = 0; i != n; ++i) {
+          uint64_t cur = static_cast<uint64_t>(a[i]) * b[j] + expected[i + j] + row;
+          expected[i + j] = static_cast<uint32_t>(cur);
+          row = cur >> 32;
+        }
+        expected[j + n] = static_cast<uint32_t>(row);
+      }
+      mul_basecase(a.data(), n, b.data(), m, res.data());
+      EXPECT_EQ(expected, res);
+    }
+  }
+}
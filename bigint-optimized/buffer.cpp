@@ -3,27 +3,83 @@
 //
 
 #include "buffer.h"
+#include <algorithm>
+#include <new>
 
-buffer::buffer(size_t sz) : ref_counter(1), mas(sz) {}
+buffer::buffer(size_t capacity, limb_allocator* allocator)
+        : ref_counter(1), cap(capacity), allocator(allocator) {}
 
+buffer* buffer::allocate(size_t capacity) {
+    limb_allocator* allocator = limb_allocator::current();
+    size_t bytes = sizeof(buffer) + capacity * sizeof(uint32_t);
+    void* place = allocator->allocate(bytes);
+    return new (place) buffer((bytes - sizeof(buffer)) / sizeof(uint32_t), allocator);
+}
+
+buffer* buffer::allocate(uint32_t const* src, size_t sz, size_t capacity) {
+    buffer* res = allocate(std::max(sz, capacity));
+    std::copy(src, src + sz, res->data());
+    return res;
+}
+
+void buffer::release(buffer* buf) {
+    limb_allocator* allocator = buf->allocator;
+    size_t bytes = sizeof(buffer) + buf->cap * sizeof(uint32_t);
+    buf->~buffer();
+    allocator->deallocate(buf, bytes);
+}
+
+#ifdef BIGINT_SINGLE_THREADED
 size_t buffer::get_ref_counter() const {
     return ref_counter;
 }
 
 size_t buffer::inc_ref_counter() {
-    return ++ref_counter;
+    return (ref_counter == PERSISTENT ? ref_counter : ++ref_counter);
 }
 
 size_t buffer::dec_ref_counter() {
-    return --ref_counter;
+    return (ref_counter == PERSISTENT ? ref_counter : --ref_counter);
 }
 
-std::vector<uint32_t> &buffer::get_mas() {
-    return mas;
+void buffer::make_persistent() {
+    ref_counter = PERSISTENT;
+}
+#else
+// acquire pairs with the release in dec_ref_counter: once an owner sees
+// itself as the only one, all writes of former co-owners are visible
+size_t buffer::get_ref_counter() const {
+    return ref_counter.load(std::memory_order_acquire);
 }
 
-buffer::buffer() : ref_counter(1), mas(std::vector<uint32_t>()) {}
+// a new reference is always made from an existing one, nothing to order
+size_t buffer::inc_ref_counter() {
+    if (ref_counter.load(std::memory_order_relaxed) == PERSISTENT) {
+        return PERSISTENT;
+    }
+    return ref_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
 
-buffer::buffer(std::vector<uint32_t> vec) : ref_counter(1), mas(std::move(vec)) {}
+size_t buffer::dec_ref_counter() {
+    if (ref_counter.load(std::memory_order_relaxed) == PERSISTENT) {
+        return PERSISTENT;
+    }
+    return ref_counter.fetch_sub(1, std::memory_order_acq_rel) - 1;
+}
 
-buffer::~buffer() = default;
+void buffer::make_persistent() {
+    ref_counter.store(PERSISTENT, std::memory_order_release);
+}
+#endif
+
+size_t buffer::capacity() const {
+    return cap;
+}
+
+uint32_t* buffer::data() {
+    return reinterpret_cast<uint32_t*>(this + 1);
+}
+
+uint32_t const* buffer::data() const {
+    return reinterpret_cast<uint32_t const*>(this + 1);
+}
@@ -7,23 +7,37 @@
 #define BIGINT_BUFFER_H
 
 #include <cstddef>
-#include <vector>
 #include <cstdint>
+#include "limb_allocator.h"
+#ifndef BIGINT_SINGLE_THREADED
+#include <atomic>
+#endif
 
+// header of a single heap block, the limbs follow it in the same allocation
 struct buffer {
 public:
-    buffer(size_t sz);
-    buffer();
-    buffer(std::vector<uint32_t> vec);
-    ~buffer();
+    static buffer* allocate(size_t capacity);
+    static buffer* allocate(uint32_t const* src, size_t sz, size_t capacity);
+    static void release(buffer* buf);
     size_t get_ref_counter() const;
     size_t inc_ref_counter();
     size_t dec_ref_counter();
-    std::vector<uint32_t> &get_mas();
+    void make_persistent();
+    size_t capacity() const;
+    uint32_t* data();
+    uint32_t const* data() const;
 private:
+    buffer(size_t capacity, limb_allocator* allocator);
+    buffer(buffer const& other) = delete;
+    buffer& operator=(buffer const& other) = delete;
+    static const size_t PERSISTENT = SIZE_MAX;
+#ifdef BIGINT_SINGLE_THREADED
     size_t ref_counter;
-    std::vector<uint32_t> mas;
+#else
+    std::atomic<size_t> ref_counter;
+#endif
+    size_t cap;
+    limb_allocator* allocator;
 };
 
 #endif //BIGINT_BUFFER_H
-
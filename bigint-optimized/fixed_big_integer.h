@@ -0,0 +1,383 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_FIXED_BIG_INTEGER_H
+#define BIGINT_FIXED_BIG_INTEGER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <stdexcept>
+#include <string>
+#include "big_integer.h"
+
+// Two's complement integer of exactly Bits bits kept in a std::array of
+// limbs. Arithmetic wraps modulo 2^Bits, everything else behaves like
+// big_integer: / and % truncate, >> rounds towards minus infinity. All loops
+// run over a compile-time number of limbs and every operation except the
+// conversions is constexpr.
+template<size_t Bits>
+struct fixed_big_integer {
+    static_assert(Bits > 0 && Bits % 32 == 0, "width must be a positive multiple of 32 bits");
+    static constexpr size_t LIMBS = Bits / 32;
+    typedef std::array<uint32_t, LIMBS> limb_array;
+
+    constexpr fixed_big_integer() : mas() {}
+
+    constexpr fixed_big_integer(int a) : mas() {
+        mas[0] = static_cast<uint32_t>(a);
+        for (size_t i = 1; i < LIMBS; i++) {
+            mas[i] = (a < 0 ? UINT32_MAX : 0);
+        }
+    }
+
+    constexpr explicit fixed_big_integer(limb_array const& limbs) : mas(limbs) {}
+
+    // keeps the lowest Bits bits of a
+    explicit fixed_big_integer(big_integer const& a) : mas() {
+        for (size_t i = 0; i < LIMBS; i++) {
+            mas[i] = a[i];
+        }
+    }
+
+    explicit fixed_big_integer(std::string const& str) : fixed_big_integer(big_integer(str)) {}
+
+    explicit operator big_integer() const {
+        big_integer res;
+        res.mas.resize(LIMBS);
+        uint32_t* out = res.mas.prepare_write(LIMBS);
+        for (size_t i = 0; i < LIMBS; i++) {
+            out[i] = mas[i];
+        }
+        res.set_sign(!is_negative());
+        return res.shrink_to_fit();
+    }
+
+    constexpr limb_array const& limbs() const {
+        return mas;
+    }
+
+    constexpr bool is_negative() const {
+        return (mas[LIMBS - 1] >> 31u) != 0;
+    }
+
+    constexpr fixed_big_integer& operator+=(fixed_big_integer const& rhs) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < LIMBS; i++) {
+            uint64_t cur = carry + mas[i] + rhs.mas[i];
+            mas[i] = static_cast<uint32_t>(cur);
+            carry = (cur >> 32u);
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator-=(fixed_big_integer const& rhs) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < LIMBS; i++) {
+            uint64_t cur = static_cast<uint64_t>(mas[i]) - rhs.mas[i] - borrow;
+            mas[i] = static_cast<uint32_t>(cur);
+            borrow = (cur >> 63u);
+        }
+        return *this;
+    }
+
+    // the low half of the product does not depend on the signs
+    constexpr fixed_big_integer& operator*=(fixed_big_integer const& rhs) {
+        limb_array res{};
+        for (size_t i = 0; i < LIMBS; i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; i + j < LIMBS; j++) {
+                uint64_t cur = static_cast<uint64_t>(mas[i]) * rhs.mas[j] + res[i + j] + carry;
+                res[i + j] = static_cast<uint32_t>(cur);
+                carry = (cur >> 32u);
+            }
+        }
+        mas = res;
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator/=(fixed_big_integer const& rhs) {
+        bool negative = (is_negative() != rhs.is_negative());
+        limb_array quotient{}, remainder{};
+        divide(abs().mas, rhs.abs().mas, quotient, remainder);
+        mas = quotient;
+        return (negative ? negate() : *this);
+    }
+
+    constexpr fixed_big_integer& operator%=(fixed_big_integer const& rhs) {
+        bool negative = is_negative();
+        limb_array quotient{}, remainder{};
+        divide(abs().mas, rhs.abs().mas, quotient, remainder);
+        mas = remainder;
+        return (negative ? negate() : *this);
+    }
+
+    constexpr fixed_big_integer& operator&=(fixed_big_integer const& rhs) {
+        for (size_t i = 0; i < LIMBS; i++) {
+            mas[i] &= rhs.mas[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator|=(fixed_big_integer const& rhs) {
+        for (size_t i = 0; i < LIMBS; i++) {
+            mas[i] |= rhs.mas[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator^=(fixed_big_integer const& rhs) {
+        for (size_t i = 0; i < LIMBS; i++) {
+            mas[i] ^= rhs.mas[i];
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator<<=(int rhs) {
+        if (rhs < 0) {
+            return (*this >>= -rhs);
+        }
+        size_t whole = static_cast<size_t>(rhs) / 32, bits = static_cast<size_t>(rhs) % 32;
+        for (size_t i = LIMBS; i >= 1; i--) {
+            uint32_t hi = (i - 1 >= whole ? mas[i - 1 - whole] : 0);
+            uint32_t lo = (i - 1 >= whole + 1 ? mas[i - 2 - whole] : 0);
+            mas[i - 1] = (bits == 0 ? hi : (hi << bits) | (lo >> (32 - bits)));
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer& operator>>=(int rhs) {
+        if (rhs < 0) {
+            return (*this <<= -rhs);
+        }
+        uint32_t end = (is_negative() ? UINT32_MAX : 0);
+        size_t whole = static_cast<size_t>(rhs) / 32, bits = static_cast<size_t>(rhs) % 32;
+        for (size_t i = 0; i < LIMBS; i++) {
+            uint32_t lo = (i + whole < LIMBS ? mas[i + whole] : end);
+            uint32_t hi = (i + whole + 1 < LIMBS ? mas[i + whole + 1] : end);
+            mas[i] = (bits == 0 ? lo : (lo >> bits) | (hi << (32 - bits)));
+        }
+        return *this;
+    }
+
+    constexpr fixed_big_integer operator+() const {
+        return *this;
+    }
+
+    constexpr fixed_big_integer operator-() const {
+        fixed_big_integer res = *this;
+        return res.negate();
+    }
+
+    constexpr fixed_big_integer operator~() const {
+        fixed_big_integer res;
+        for (size_t i = 0; i < LIMBS; i++) {
+            res.mas[i] = ~mas[i];
+        }
+        return res;
+    }
+
+    constexpr fixed_big_integer& operator++() {
+        return (*this += 1);
+    }
+
+    constexpr fixed_big_integer operator++(int) {
+        fixed_big_integer res = *this;
+        ++*this;
+        return res;
+    }
+
+    constexpr fixed_big_integer& operator--() {
+        return (*this -= 1);
+    }
+
+    constexpr fixed_big_integer operator--(int) {
+        fixed_big_integer res = *this;
+        --*this;
+        return res;
+    }
+
+    friend constexpr fixed_big_integer operator+(fixed_big_integer a, fixed_big_integer const& b) {
+        return a += b;
+    }
+
+    friend constexpr fixed_big_integer operator-(fixed_big_integer a, fixed_big_integer const& b) {
+        return a -= b;
+    }
+
+    friend constexpr fixed_big_integer operator*(fixed_big_integer a, fixed_big_integer const& b) {
+        return a *= b;
+    }
+
+    friend constexpr fixed_big_integer operator/(fixed_big_integer a, fixed_big_integer const& b) {
+        return a /= b;
+    }
+
+    friend constexpr fixed_big_integer operator%(fixed_big_integer a, fixed_big_integer const& b) {
+        return a %= b;
+    }
+
+    friend constexpr fixed_big_integer operator&(fixed_big_integer a, fixed_big_integer const& b) {
+        return a &= b;
+    }
+
+    friend constexpr fixed_big_integer operator|(fixed_big_integer a, fixed_big_integer const& b) {
+        return a |= b;
+    }
+
+    friend constexpr fixed_big_integer operator^(fixed_big_integer a, fixed_big_integer const& b) {
+        return a ^= b;
+    }
+
+    friend constexpr fixed_big_integer operator<<(fixed_big_integer a, int b) {
+        return a <<= b;
+    }
+
+    friend constexpr fixed_big_integer operator>>(fixed_big_integer a, int b) {
+        return a >>= b;
+    }
+
+    friend constexpr bool operator==(fixed_big_integer const& a, fixed_big_integer const& b) {
+        for (size_t i = 0; i < LIMBS; i++) {
+            if (a.mas[i] != b.mas[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator!=(fixed_big_integer const& a, fixed_big_integer const& b) {
+        return !(a == b);
+    }
+
+    friend constexpr bool operator<=(fixed_big_integer const& a, fixed_big_integer const& b) {
+        if (a.is_negative() != b.is_negative()) {
+            return a.is_negative();
+        }
+        for (size_t i = LIMBS; i >= 1; i--) {
+            if (a.mas[i - 1] != b.mas[i - 1]) {
+                return (a.mas[i - 1] < b.mas[i - 1]);
+            }
+        }
+        return true;
+    }
+
+    friend constexpr bool operator<(fixed_big_integer const& a, fixed_big_integer const& b) {
+        return !(b <= a);
+    }
+
+    friend constexpr bool operator>(fixed_big_integer const& a, fixed_big_integer const& b) {
+        return !(a <= b);
+    }
+
+    friend constexpr bool operator>=(fixed_big_integer const& a, fixed_big_integer const& b) {
+        return (b <= a);
+    }
+
+    friend std::string to_string(fixed_big_integer const& a) {
+        return to_string(big_integer(a));
+    }
+
+    friend std::ostream& operator<<(std::ostream& s, fixed_big_integer const& a) {
+        return s << big_integer(a);
+    }
+
+private:
+    constexpr fixed_big_integer& negate() {
+        uint64_t carry = 1;
+        for (size_t i = 0; i < LIMBS; i++) {
+            uint64_t cur = carry + static_cast<uint32_t>(~mas[i]);
+            mas[i] = static_cast<uint32_t>(cur);
+            carry = (cur >> 32u);
+        }
+        return *this;
+    }
+
+    // the magnitude of the minimal value, 2^(Bits - 1), still fits the
+    // unsigned reading of the limbs
+    constexpr fixed_big_integer abs() const {
+        return (is_negative() ? -*this : *this);
+    }
+
+    // unsigned long division of Bits-bit magnitudes, Knuth's algorithm D
+    static constexpr void divide(limb_array const& u, limb_array const& v, limb_array& q, limb_array& r) {
+        size_t n = LIMBS, m = LIMBS;
+        while (n > 0 && v[n - 1] == 0) {
+            n--;
+        }
+        while (m > 0 && u[m - 1] == 0) {
+            m--;
+        }
+        if (n == 0) {
+            throw std::runtime_error("divide by zero");
+        }
+        if (m < n) {
+            r = u;
+            return;
+        }
+        if (n == 1) {
+            uint64_t rem = 0;
+            for (size_t i = m; i >= 1; i--) {
+                uint64_t cur = (rem << 32u) | u[i - 1];
+                q[i - 1] = static_cast<uint32_t>(cur / v[0]);
+                rem = cur % v[0];
+            }
+            r[0] = static_cast<uint32_t>(rem);
+            return;
+        }
+        size_t shift = 0;
+        while ((v[n - 1] << shift) >> 31u == 0) {
+            shift++;
+        }
+        std::array<uint32_t, LIMBS + 1> un{};
+        limb_array vn{};
+        for (size_t i = 0; i < n; i++) {
+            vn[i] = (v[i] << shift) | (shift != 0 && i != 0 ? v[i - 1] >> (32 - shift) : 0);
+        }
+        for (size_t i = 0; i <= m; i++) {
+            uint32_t lo = (i != 0 && shift != 0 ? u[i - 1] >> (32 - shift) : 0);
+            un[i] = (i < m ? u[i] << shift : 0) | lo;
+        }
+        for (size_t j = m - n + 1; j >= 1; j--) {
+            uint64_t top = (static_cast<uint64_t>(un[j - 1 + n]) << 32u) | un[j - 2 + n];
+            uint64_t qhat = top / vn[n - 1];
+            uint64_t rhat = top % vn[n - 1];
+            while (qhat >> 32u != 0 || qhat * vn[n - 2] > ((rhat << 32u) | un[j - 3 + n])) {
+                qhat--;
+                rhat += vn[n - 1];
+                if (rhat >> 32u != 0) {
+                    break;
+                }
+            }
+            int64_t borrow = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t p = qhat * vn[i];
+                int64_t t = static_cast<int64_t>(un[i + j - 1]) - borrow - static_cast<int64_t>(p & UINT32_MAX);
+                un[i + j - 1] = static_cast<uint32_t>(t);
+                borrow = static_cast<int64_t>(p >> 32u) - (t >> 32);
+            }
+            int64_t t = static_cast<int64_t>(un[j - 1 + n]) - borrow;
+            un[j - 1 + n] = static_cast<uint32_t>(t);
+            if (t < 0) {
+                qhat--;
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; i++) {
+                    uint64_t cur = static_cast<uint64_t>(un[i + j - 1]) + vn[i] + carry;
+                    un[i + j - 1] = static_cast<uint32_t>(cur);
+                    carry = (cur >> 32u);
+                }
+                un[j - 1 + n] += static_cast<uint32_t>(carry);
+            }
+            q[j - 1] = static_cast<uint32_t>(qhat);
+        }
+        for (size_t i = 0; i < n; i++) {
+            r[i] = (un[i] >> shift) | (shift != 0 ? un[i + 1] << (32 - shift) : 0);
+        }
+    }
+
+    limb_array mas;
+};
+
+#endif //BIGINT_FIXED_BIG_INTEGER_H
@@ -0,0 +1,167 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include "limb_allocator.h"
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+const size_t pool_allocator::MIN_BLOCK;
+const size_t pool_allocator::MAX_BLOCK;
+const size_t pool_allocator::MAX_CACHED_BYTES;
+
+namespace {
+std::atomic<limb_allocator*> global_allocator(nullptr);
+thread_local limb_allocator* thread_allocator = nullptr;
+
+std::atomic<size_t> flushed_hits(0);
+std::atomic<size_t> flushed_misses(0);
+
+size_t const CLASSES_COUNT = 15;
+size_t const STATS_FLUSH_PERIOD = 1024;
+
+size_t size_class(size_t bytes) {
+    size_t cls = 0;
+    while ((pool_allocator::MIN_BLOCK << cls) < bytes) {
+        cls++;
+    }
+    return cls;
+}
+
+struct free_block {
+    free_block* next;
+};
+
+struct thread_cache {
+    thread_cache();
+    ~thread_cache();
+    void count(bool hit);
+    void flush_stats();
+
+    free_block* lists[CLASSES_COUNT] = {};
+    size_t cached[CLASSES_COUNT] = {};
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+// trivially destructible, so it can still be read after the cache is gone
+enum cache_state_t { NOT_CREATED, ALIVE, DESTROYED };
+thread_local cache_state_t cache_state = NOT_CREATED;
+thread_local thread_cache cache;
+
+thread_cache::thread_cache() {
+    cache_state = ALIVE;
+}
+
+thread_cache::~thread_cache() {
+    for (size_t cls = 0; cls < CLASSES_COUNT; cls++) {
+        while (lists[cls] != nullptr) {
+            free_block* block = lists[cls];
+            lists[cls] = block->next;
+            ::operator delete(block);
+        }
+    }
+    flush_stats();
+    cache_state = DESTROYED;
+}
+
+void thread_cache::count(bool hit) {
+    (hit ? hits : misses)++;
+    if (hits + misses == STATS_FLUSH_PERIOD) {
+        flush_stats();
+    }
+}
+
+void thread_cache::flush_stats() {
+    flushed_hits.fetch_add(hits, std::memory_order_relaxed);
+    flushed_misses.fetch_add(misses, std::memory_order_relaxed);
+    hits = 0;
+    misses = 0;
+}
+}
+
+limb_allocator* limb_allocator::current() {
+    if (thread_allocator != nullptr) {
+        return thread_allocator;
+    }
+    limb_allocator* global = global_allocator.load(std::memory_order_acquire);
+    return (global != nullptr ? global : &pool_allocator::instance());
+}
+
+void limb_allocator::set_global(limb_allocator* allocator) {
+    global_allocator.store(allocator, std::memory_order_release);
+}
+
+limb_allocator* limb_allocator::set_thread_local(limb_allocator* allocator) {
+    limb_allocator* previous = thread_allocator;
+    thread_allocator = allocator;
+    return previous;
+}
+
+// never destroyed: buffers of static objects may be released after main
+pool_allocator& pool_allocator::instance() {
+    static pool_allocator* pool = new pool_allocator();
+    return *pool;
+}
+
+void* pool_allocator::allocate(size_t& bytes) {
+    if (bytes > MAX_BLOCK) {
+        if (cache_state != DESTROYED) {
+            cache.count(false);
+        }
+        return ::operator new(bytes);
+    }
+    // a block always has its class size, a thread with a live cache may free it
+    size_t cls = size_class(bytes);
+    bytes = (MIN_BLOCK << cls);
+    if (cache_state == DESTROYED) {
+        return ::operator new(bytes);
+    }
+    free_block* block = cache.lists[cls];
+    cache.count(block != nullptr);
+    if (block == nullptr) {
+        return ::operator new(bytes);
+    }
+    cache.lists[cls] = block->next;
+    cache.cached[cls] -= bytes;
+    return block;
+}
+
+void pool_allocator::deallocate(void* ptr, size_t bytes) {
+    if (bytes > MAX_BLOCK || cache_state == DESTROYED) {
+        ::operator delete(ptr);
+        return;
+    }
+    size_t cls = size_class(bytes);
+    if (cache.cached[cls] + bytes > MAX_CACHED_BYTES) {
+        ::operator delete(ptr);
+        return;
+    }
+    free_block* block = static_cast<free_block*>(ptr);
+    block->next = cache.lists[cls];
+    cache.lists[cls] = block;
+    cache.cached[cls] += bytes;
+}
+
+pool_allocator::statistics pool_allocator::stats() const {
+    statistics res = {flushed_hits.load(std::memory_order_relaxed), flushed_misses.load(std::memory_order_relaxed)};
+    if (cache_state == ALIVE) {
+        res.hits += cache.hits;
+        res.misses += cache.misses;
+    }
+    return res;
+}
+
+void pool_allocator::reset_stats() {
+    if (cache_state == ALIVE) {
+        cache.hits = 0;
+        cache.misses = 0;
+    }
+    flushed_hits.store(0, std::memory_order_relaxed);
+    flushed_misses.store(0, std::memory_order_relaxed);
+}
+
+double pool_allocator::statistics::hit_rate() const {
+    return (hits + misses == 0 ? 0 : static_cast<double>(hits) / static_cast<double>(hits + misses));
+}
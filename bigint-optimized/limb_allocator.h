@@ -0,0 +1,49 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_LIMB_ALLOCATOR_H
+#define BIGINT_LIMB_ALLOCATOR_H
+
+#include <cstddef>
+
+// Source of memory for heap buffers. allocate may round the requested byte
+// count up and reports the granted size back, deallocate receives it again.
+struct limb_allocator {
+    virtual ~limb_allocator() = default;
+    virtual void* allocate(size_t& bytes) = 0;
+    virtual void deallocate(void* ptr, size_t bytes) = 0;
+
+    // allocator used for new buffers, the pool unless another one was set
+    static limb_allocator* current();
+    // nullptr restores the pool; buffers remember where they came from, so
+    // an allocator must outlive every buffer it handed out
+    static void set_global(limb_allocator* allocator);
+    static limb_allocator* set_thread_local(limb_allocator* allocator);
+};
+
+// Power-of-two size classes with a free list per class in every thread.
+// Blocks freed by a thread go to its own lists, blocks above MAX_BLOCK and
+// lists over their quota go back to the global heap.
+struct pool_allocator : limb_allocator {
+    struct statistics {
+        size_t hits;
+        size_t misses;
+        double hit_rate() const;
+    };
+
+    static pool_allocator& instance();
+
+    void* allocate(size_t& bytes) override;
+    void deallocate(void* ptr, size_t bytes) override;
+    statistics stats() const;
+    void reset_stats();
+
+    static const size_t MIN_BLOCK = 64;
+    static const size_t MAX_BLOCK = size_t(1) << 20u;
+    static const size_t MAX_CACHED_BYTES = size_t(1) << 20u;
+private:
+    pool_allocator() = default;
+};
+
+#endif //BIGINT_LIMB_ALLOCATOR_H
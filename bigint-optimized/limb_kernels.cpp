@@ -0,0 +1,444 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include "limb_kernels.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BIGINT_X86_KERNELS
+#endif
+
+#ifdef __x86_64__
+#define BIGINT_X86_64_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace {
+typedef uint32_t limb_x4 __attribute__((vector_size(16)));
+typedef uint32_t limb_x8 __attribute__((vector_size(32)));
+
+// Vector is uint32_t for the scalar variant. The loops are always inlined
+// into the variants below, so they are compiled for the instruction set of
+// the variant and a vector never crosses a call
+template<typename Vector, typename Op>
+__attribute__((always_inline)) inline void bitwise_n_loop(uint32_t* dst, uint32_t const* a, uint32_t const* b,
+                                                          size_t n) {
+    size_t const lanes = sizeof(Vector) / sizeof(uint32_t);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        Vector x, y;
+        std::memcpy(&x, a + i, sizeof(Vector));
+        std::memcpy(&y, b + i, sizeof(Vector));
+        Op::apply(x, y);
+        std::memcpy(dst + i, &x, sizeof(Vector));
+    }
+    for (; i < n; i++) {
+        uint32_t x = a[i];
+        Op::apply(x, b[i]);
+        dst[i] = x;
+    }
+}
+
+template<typename Vector, typename Op>
+__attribute__((always_inline)) inline void bitwise_1_loop(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n) {
+    size_t const lanes = sizeof(Vector) / sizeof(uint32_t);
+    Vector y = Vector() + b;
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        Vector x;
+        std::memcpy(&x, a + i, sizeof(Vector));
+        Op::apply(x, y);
+        std::memcpy(dst + i, &x, sizeof(Vector));
+    }
+    for (; i < n; i++) {
+        uint32_t x = a[i];
+        Op::apply(x, b);
+        dst[i] = x;
+    }
+}
+
+template<typename Op>
+void bitwise_n_scalar(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    bitwise_n_loop<uint32_t, Op>(dst, a, b, n);
+}
+
+template<typename Op>
+void bitwise_1_scalar(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n) {
+    bitwise_1_loop<uint32_t, Op>(dst, a, b, n);
+}
+
+#ifdef BIGINT_X86_KERNELS
+template<typename Op>
+__attribute__((target("sse2"))) void bitwise_n_sse2(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    bitwise_n_loop<limb_x4, Op>(dst, a, b, n);
+}
+
+template<typename Op>
+__attribute__((target("sse2"))) void bitwise_1_sse2(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n) {
+    bitwise_1_loop<limb_x4, Op>(dst, a, b, n);
+}
+
+template<typename Op>
+__attribute__((target("avx2"))) void bitwise_n_avx2(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    bitwise_n_loop<limb_x8, Op>(dst, a, b, n);
+}
+
+template<typename Op>
+__attribute__((target("avx2"))) void bitwise_1_avx2(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n) {
+    bitwise_1_loop<limb_x8, Op>(dst, a, b, n);
+}
+#endif
+}
+
+namespace {
+uint32_t add_n_portable(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t cur = carry + a[i] + b[i];
+        dst[i] = static_cast<uint32_t>(cur);
+        carry = (cur >> 32u);
+    }
+    return static_cast<uint32_t>(carry);
+}
+
+uint32_t sub_n_portable(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t cur = static_cast<uint64_t>(a[i]) - b[i] - borrow;
+        dst[i] = static_cast<uint32_t>(cur);
+        borrow = (cur >> 63u);
+    }
+    return static_cast<uint32_t>(borrow);
+}
+
+uint32_t mul_1_portable(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b, uint32_t carry) {
+    uint64_t rem = carry;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t cur = static_cast<uint64_t>(a[i]) * b + rem;
+        dst[i] = static_cast<uint32_t>(cur);
+        rem = (cur >> 32u);
+    }
+    return static_cast<uint32_t>(rem);
+}
+
+uint32_t addmul_1_portable(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b) {
+    uint64_t rem = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t cur = static_cast<uint64_t>(a[i]) * b + dst[i] + rem;
+        dst[i] = static_cast<uint32_t>(cur);
+        rem = (cur >> 32u);
+    }
+    return static_cast<uint32_t>(rem);
+}
+
+void mul_basecase_portable(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* res) {
+    for (size_t i = 0; i < m; i++) {
+        res[i + n] = addmul_1_portable(res + i, a, n, b[i]);
+    }
+}
+
+#ifdef BIGINT_X86_64_KERNELS
+// The BMI2/ADX variants step over pairs of limbs as 64-bit words, an odd
+// top limb is finished separately. Words are moved with memcpy, so limb
+// arrays need no particular alignment.
+uint64_t load_word(uint32_t const* p) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+void store_word(uint32_t* p, uint64_t w) {
+    std::memcpy(p, &w, sizeof(w));
+}
+
+__attribute__((target("bmi2,adx"))) uint32_t add_n_adx(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    unsigned char carry = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        unsigned long long cur;
+        carry = _addcarry_u64(carry, load_word(a + i), load_word(b + i), &cur);
+        store_word(dst + i, cur);
+    }
+    if (i < n) {
+        unsigned int cur;
+        carry = _addcarry_u32(carry, a[i], b[i], &cur);
+        dst[i] = cur;
+    }
+    return carry;
+}
+
+__attribute__((target("bmi2,adx"))) uint32_t sub_n_adx(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    unsigned char borrow = 0;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        unsigned long long cur;
+        borrow = _subborrow_u64(borrow, load_word(a + i), load_word(b + i), &cur);
+        store_word(dst + i, cur);
+    }
+    if (i < n) {
+        unsigned int cur;
+        borrow = _subborrow_u32(borrow, a[i], b[i], &cur);
+        dst[i] = cur;
+    }
+    return borrow;
+}
+
+__attribute__((target("bmi2,adx"))) uint32_t mul_1_adx(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b,
+                                                       uint32_t carry) {
+    uint64_t rem = carry;
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __uint128_t cur = static_cast<__uint128_t>(load_word(a + i)) * b + rem;
+        store_word(dst + i, static_cast<uint64_t>(cur));
+        rem = static_cast<uint64_t>(cur >> 64u);
+    }
+    if (i < n) {
+        uint64_t cur = static_cast<uint64_t>(a[i]) * b + rem;
+        dst[i] = static_cast<uint32_t>(cur);
+        rem = (cur >> 32u);
+    }
+    return static_cast<uint32_t>(rem);
+}
+
+// dst[0, 2 words) += a[0, 2 words) * b for words > 0, returns the high word.
+// MULX leaves the flags alone, so the high half of the previous product is
+// added on the CF chain (ADCX) while dst is added on the OF chain (ADOX);
+// LEA and JRCXZ keep both chains intact across iterations.
+__attribute__((target("bmi2,adx"))) uint64_t addmul_words(uint32_t* dst, uint32_t const* a, size_t words,
+                                                          uint64_t b) {
+    uint64_t high, lo, hi;
+    __asm__ volatile(
+        "xor %[high], %[high]\n\t"
+        "1:\n\t"
+        "mulx (%[a]), %[lo], %[hi]\n\t"
+        "adcx %[high], %[lo]\n\t"
+        "adox (%[dst]), %[lo]\n\t"
+        "mov %[lo], (%[dst])\n\t"
+        "mov %[hi], %[high]\n\t"
+        "lea 8(%[a]), %[a]\n\t"
+        "lea 8(%[dst]), %[dst]\n\t"
+        "lea -1(%[words]), %[words]\n\t"
+        "jrcxz 2f\n\t"
+        "jmp 1b\n\t"
+        "2:\n\t"
+        "mov $0, %[lo]\n\t"
+        "adcx %[lo], %[high]\n\t"
+        "adox %[lo], %[high]\n\t"
+        : [high] "=&r"(high), [lo] "=&r"(lo), [hi] "=&r"(hi), [a] "+r"(a), [dst] "+r"(dst), [words] "+c"(words)
+        : "d"(b)
+        : "cc", "memory");
+    return high;
+}
+
+// dst[0, n) += a[0, n) * b for a multiplier of up to 64 bits, returns the
+// carry out of the top limb
+__attribute__((target("bmi2,adx"))) uint64_t addmul_row(uint32_t* dst, uint32_t const* a, size_t n, uint64_t b) {
+    uint64_t carry = (n >= 2 ? addmul_words(dst, a, n / 2, b) : 0);
+    if (n % 2 == 1) {
+        __uint128_t cur = static_cast<__uint128_t>(a[n - 1]) * b + dst[n - 1] + carry;
+        dst[n - 1] = static_cast<uint32_t>(cur);
+        carry = static_cast<uint64_t>(cur >> 32u);
+    }
+    return carry;
+}
+
+// a 32-bit multiplier keeps the carry below 2^32
+__attribute__((target("bmi2,adx"))) uint32_t addmul_1_adx(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b) {
+    return static_cast<uint32_t>(addmul_row(dst, a, n, b));
+}
+
+// one row per pair of limbs of b; the carry of a row lands in limbs that no
+// earlier row has reached
+__attribute__((target("bmi2,adx"))) void mul_basecase_adx(uint32_t const* a, size_t n, uint32_t const* b, size_t m,
+                                                          uint32_t* res) {
+    size_t j = 0;
+    for (; j + 2 <= m; j += 2) {
+        uint64_t carry = addmul_row(res + j, a, n, load_word(b + j));
+        store_word(res + j + n, carry);
+    }
+    if (j < m) {
+        res[j + n] = static_cast<uint32_t>(addmul_row(res + j, a, n, b[j]));
+    }
+}
+#endif
+}
+
+namespace {
+bool always_supported() {
+    return true;
+}
+
+#ifdef BIGINT_X86_KERNELS
+bool sse2_supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+bool avx2_supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#ifdef BIGINT_X86_64_KERNELS
+bool bmi2_adx_supported() {
+    __builtin_cpu_init();
+    return avx2_supported() && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+}
+#endif
+
+typedef void (*bitwise_n_kernel)(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+typedef void (*bitwise_1_kernel)(uint32_t*, uint32_t const*, uint32_t, size_t);
+
+// bitwise kernels are indexed by operation
+template<typename Op>
+struct op_index;
+
+template<>
+struct op_index<bit_and> {
+    static const size_t value = 0;
+};
+
+template<>
+struct op_index<bit_or> {
+    static const size_t value = 1;
+};
+
+template<>
+struct op_index<bit_xor> {
+    static const size_t value = 2;
+};
+
+struct kernel_table {
+    char const* name;
+    bool (*supported)();
+    bitwise_n_kernel bitwise_n[3];
+    bitwise_1_kernel bitwise_1[3];
+    uint32_t (*add_n)(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+    uint32_t (*sub_n)(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+    uint32_t (*mul_1)(uint32_t*, uint32_t const*, size_t, uint32_t, uint32_t);
+    uint32_t (*addmul_1)(uint32_t*, uint32_t const*, size_t, uint32_t);
+    void (*mul_basecase)(uint32_t const*, size_t, uint32_t const*, size_t, uint32_t*);
+    // operand length from which Karatsuba beats mul_basecase
+    size_t karatsuba_threshold;
+};
+
+// best first; the 64-bit rows of the BMI2/ADX basecase move the Karatsuba
+// crossover up
+kernel_table const VARIANTS[] = {
+#ifdef BIGINT_X86_64_KERNELS
+    {"bmi2-adx", bmi2_adx_supported,
+     {bitwise_n_avx2<bit_and>, bitwise_n_avx2<bit_or>, bitwise_n_avx2<bit_xor>},
+     {bitwise_1_avx2<bit_and>, bitwise_1_avx2<bit_or>, bitwise_1_avx2<bit_xor>},
+     add_n_adx, sub_n_adx, mul_1_adx, addmul_1_adx, mul_basecase_adx, 64},
+#endif
+#ifdef BIGINT_X86_KERNELS
+    {"avx2", avx2_supported,
+     {bitwise_n_avx2<bit_and>, bitwise_n_avx2<bit_or>, bitwise_n_avx2<bit_xor>},
+     {bitwise_1_avx2<bit_and>, bitwise_1_avx2<bit_or>, bitwise_1_avx2<bit_xor>},
+     add_n_portable, sub_n_portable, mul_1_portable, addmul_1_portable, mul_basecase_portable, 32},
+    {"sse2", sse2_supported,
+     {bitwise_n_sse2<bit_and>, bitwise_n_sse2<bit_or>, bitwise_n_sse2<bit_xor>},
+     {bitwise_1_sse2<bit_and>, bitwise_1_sse2<bit_or>, bitwise_1_sse2<bit_xor>},
+     add_n_portable, sub_n_portable, mul_1_portable, addmul_1_portable, mul_basecase_portable, 32},
+#endif
+    {"scalar", always_supported,
+     {bitwise_n_scalar<bit_and>, bitwise_n_scalar<bit_or>, bitwise_n_scalar<bit_xor>},
+     {bitwise_1_scalar<bit_and>, bitwise_1_scalar<bit_or>, bitwise_1_scalar<bit_xor>},
+     add_n_portable, sub_n_portable, mul_1_portable, addmul_1_portable, mul_basecase_portable, 32},
+};
+
+kernel_table const* find_variant(char const* name) {
+    for (kernel_table const& variant : VARIANTS) {
+        if (std::strcmp(variant.name, name) == 0) {
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+
+kernel_table const& resolve() {
+    char const* forced = std::getenv("BIGINT_KERNELS");
+    if (forced != nullptr && find_variant(forced) == nullptr) {
+        std::fprintf(stderr, "BIGINT_KERNELS=%s names no kernel variant, it is ignored\n", forced);
+    }
+    if (forced != nullptr && kernels_supported(forced)) {
+        return *find_variant(forced);
+    }
+    for (kernel_table const& variant : VARIANTS) {
+        if (variant.supported()) {
+            return variant;
+        }
+    }
+    return VARIANTS[sizeof(VARIANTS) / sizeof(VARIANTS[0]) - 1];
+}
+
+kernel_table const& kernels() {
+    static kernel_table const& active = resolve();
+    return active;
+}
+
+// resolve during static initialization rather than inside the first kernel call
+kernel_table const& resolved_at_startup = kernels();
+}
+
+template<typename Op>
+void bitwise_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    kernels().bitwise_n[op_index<Op>::value](dst, a, b, n);
+}
+
+template<typename Op>
+void bitwise_1(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n) {
+    kernels().bitwise_1[op_index<Op>::value](dst, a, b, n);
+}
+
+uint32_t add_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    return kernels().add_n(dst, a, b, n);
+}
+
+uint32_t sub_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n) {
+    return kernels().sub_n(dst, a, b, n);
+}
+
+uint32_t mul_1(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b, uint32_t carry) {
+    return kernels().mul_1(dst, a, n, b, carry);
+}
+
+uint32_t addmul_1(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b) {
+    return kernels().addmul_1(dst, a, n, b);
+}
+
+void mul_basecase(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* res) {
+    kernels().mul_basecase(a, n, b, m, res);
+}
+
+size_t karatsuba_threshold() {
+    return kernels().karatsuba_threshold;
+}
+
+char const* active_kernels() {
+    return kernels().name;
+}
+
+bool kernels_supported(char const* name) {
+    kernel_table const* variant = find_variant(name);
+    return variant != nullptr && variant->supported();
+}
+
+std::vector<char const*> kernel_variants() {
+    std::vector<char const*> res;
+    for (kernel_table const& variant : VARIANTS) {
+        res.push_back(variant.name);
+    }
+    return res;
+}
+
+template void bitwise_n<bit_and>(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+template void bitwise_n<bit_or>(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+template void bitwise_n<bit_xor>(uint32_t*, uint32_t const*, uint32_t const*, size_t);
+template void bitwise_1<bit_and>(uint32_t*, uint32_t const*, uint32_t, size_t);
+template void bitwise_1<bit_or>(uint32_t*, uint32_t const*, uint32_t, size_t);
+template void bitwise_1<bit_xor>(uint32_t*, uint32_t const*, uint32_t, size_t);
@@ -0,0 +1,71 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_LIMB_KERNELS_H
+#define BIGINT_LIMB_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Loops over limb arrays that have variants for several instruction sets.
+// One table of kernels is resolved from cpuid at startup: the best variant
+// the CPU supports, or the one named by the BIGINT_KERNELS environment
+// variable if the CPU supports that. A name that matches no variant is
+// reported on stderr.
+//
+// A bitwise operation updates its first argument in place and is applied to
+// single limbs as well as to whole vectors of them; vectors are passed by
+// reference so that none crosses a call by value.
+struct bit_and {
+    template<typename T>
+    static void apply(T& a, T const& b) { a &= b; }
+};
+
+struct bit_or {
+    template<typename T>
+    static void apply(T& a, T const& b) { a |= b; }
+};
+
+struct bit_xor {
+    template<typename T>
+    static void apply(T& a, T const& b) { a ^= b; }
+};
+
+// dst[i] = op(a[i], b[i]) for i < n, dst may be a or b
+template<typename Op>
+void bitwise_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n);
+
+// dst[i] = op(a[i], b) for i < n, dst may be a
+template<typename Op>
+void bitwise_1(uint32_t* dst, uint32_t const* a, uint32_t b, size_t n);
+
+// dst = a + b over n limbs, returns the carry out; dst may be a or b
+uint32_t add_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n);
+
+// dst = a - b over n limbs, returns the borrow out; dst may be a or b
+uint32_t sub_n(uint32_t* dst, uint32_t const* a, uint32_t const* b, size_t n);
+
+// dst = a * b + carry over n limbs, returns the high limb; dst may be a
+uint32_t mul_1(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b, uint32_t carry);
+
+// dst += a * b over n limbs, returns the high limb; dst must not overlap a
+uint32_t addmul_1(uint32_t* dst, uint32_t const* a, size_t n, uint32_t b);
+
+// res[0, n + m) = a * b, res must be zero on entry and overlap neither operand
+void mul_basecase(uint32_t const* a, size_t n, uint32_t const* b, size_t m, uint32_t* res);
+
+// operand length from which Karatsuba beats the active mul_basecase
+size_t karatsuba_threshold();
+
+// name of the active variant: "bmi2-adx", "avx2", "sse2" or "scalar"
+char const* active_kernels();
+
+// whether the named variant exists and this CPU can run it
+bool kernels_supported(char const* name);
+
+// every variant built into the library, best first
+std::vector<char const*> kernel_variants();
+
+#endif //BIGINT_LIMB_KERNELS_H
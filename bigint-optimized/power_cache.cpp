@@ -0,0 +1,93 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#include "power_cache.h"
+#include "limb_allocator.h"
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace {
+struct cache_state {
+    std::mutex lock;
+    std::map<uint32_t, std::vector<big_integer> > powers;
+    size_t usage = 0;
+    size_t limit = (size_t(1) << 22u);
+};
+
+// never destroyed: cached buffers must outlive every copy handed out
+cache_state& state() {
+    static cache_state* instance = new cache_state();
+    return *instance;
+}
+
+// cached buffers outlive any arena_scope or custom allocator that is active
+// while they are computed, so they always come from the pool; a thread-local
+// allocator takes precedence over the global one
+struct pool_only {
+    pool_only() : previous(limb_allocator::set_thread_local(&pool_allocator::instance())) {}
+    ~pool_only() {
+        limb_allocator::set_thread_local(previous);
+    }
+    limb_allocator* previous;
+};
+}
+
+big_integer power_cache::power(uint32_t base, size_t k) {
+    pool_only pool;
+    cache_state& cache = state();
+    std::unique_lock<std::mutex> guard(cache.lock);
+    std::vector<big_integer>& row = cache.powers[base];
+    if (row.empty()) {
+        big_integer first(1);
+        first.mul(base);
+        row.push_back(first);
+    }
+    while (row.size() <= k) {
+        size_t next_k = row.size();
+        big_integer next = row.back();
+        guard.unlock();
+        next *= next;
+        guard.lock();
+        if (row.size() != next_k) {
+            continue;
+        }
+        if (cache.usage + next.mas.size() > cache.limit) {
+            guard.unlock();
+            for (; next_k < k; next_k++) {
+                next *= next;
+            }
+            return next;
+        }
+        next.mas.make_persistent();
+        cache.usage += next.mas.size();
+        row.push_back(next);
+    }
+    return row[k];
+}
+
+void power_cache::warm_up(uint32_t base, size_t limbs) {
+    if (base < 2) {
+        return;
+    }
+    for (size_t k = 0; 2 * power(base, k).mas.size() <= limbs; k++) {}
+}
+
+void power_cache::set_memory_limit(size_t limbs) {
+    cache_state& cache = state();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.limit = limbs;
+}
+
+size_t power_cache::memory_limit() {
+    cache_state& cache = state();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.limit;
+}
+
+size_t power_cache::memory_usage() {
+    cache_state& cache = state();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    return cache.usage;
+}
@@ -0,0 +1,24 @@
+//
+// Created by roma on 19.10.2026.
+//
+
+#ifndef BIGINT_POWER_CACHE_H
+#define BIGINT_POWER_CACHE_H
+
+#include "big_integer.h"
+#include <cstddef>
+#include <cstdint>
+
+// Process-wide cache of radix powers base^(2^k), shared by all threads.
+// Cached values live in persistent buffers, so copies handed out by power()
+// never touch a reference counter and may be used from any thread. They are
+// computed in the pool whatever allocator is active, including arena_scope.
+struct power_cache {
+    static big_integer power(uint32_t base, size_t k);
+    static void warm_up(uint32_t base, size_t limbs);
+    static void set_memory_limit(size_t limbs);
+    static size_t memory_limit();
+    static size_t memory_usage();
+};
+
+#endif //BIGINT_POWER_CACHE_H
@@ -5,53 +5,86 @@
 #include <cassert>
 #include "storage.h"
 
+const size_t storage::SMALL_SIZE;
 
-storage::storage() : sz(0), small(true) {}
+storage::storage() : meta(0) {}
+
+bool storage::is_small() const {
+    return (meta & HEAP_FLAG) == 0;
+}
+
+void storage::set_heap(buffer* new_data) {
+    data = new_data;
+    meta |= HEAP_FLAG;
+}
+
+void storage::set_size(size_t nw_size) {
+    meta = (meta & (HEAP_FLAG | TAG_FLAG)) | (nw_size << SIZE_SHIFT);
+}
+
+bool storage::tag() const {
+    return (meta & TAG_FLAG) != 0;
+}
+
+void storage::set_tag(bool value) {
+    meta = (value ? meta | TAG_FLAG : meta & ~TAG_FLAG);
+}
 
 void storage::unshare() {
     assert(data->get_ref_counter() > 1);
-    buffer *new_data = new buffer(data->get_mas());
-    data->dec_ref_counter();
+    reallocate(data->capacity());
+}
+
+void storage::reallocate(size_t nw_capacity) {
+    assert(!is_small());
+    buffer *new_data = buffer::allocate(data->data(), size(), nw_capacity);
+    delete_current_buffer();
     data = new_data;
 }
 
+void storage::make_unique(size_t min_capacity) {
+    if (data->capacity() < min_capacity) {
+        reallocate(std::max(min_capacity, 2 * data->capacity()));
+    } else if (data->get_ref_counter() > 1) {
+        unshare();
+    }
+}
+
 storage::~storage() {
     delete_current_buffer();
 }
 
+uint32_t const* storage::limbs() const {
+    return (is_small() ? static_mas : data->data());
+}
+
 std::vector<uint32_t> storage::get_mas_copy() const {
-    if (small) {
-        std::vector <uint32_t> res(sz);
-        std::copy(static_mas, static_mas + sz, res.begin());
-        return res;
-    } else {
-        return data->get_mas();
-    }
+    return std::vector<uint32_t>(limbs(), limbs() + size());
 }
 
 bool storage::operator==(storage const& other) const {
-    bool ok = (sz == other.sz);
-    if (!ok) {
-        return false;
+    return size() == other.size() && std::equal(limbs(), limbs() + size(), other.limbs());
+}
+
+void storage::make_persistent() {
+    if (!is_small()) {
+        check_ref_counter();
+        data->make_persistent();
     }
-    if (small && other.small) {
-        for (size_t i = 0; i < sz; i++) {
-            ok &= (static_mas[i] == other.static_mas[i]);
-        }
-    } else if (small && !other.small) {
-        for (size_t i = 0; i < sz; i++) {
-            ok &= (static_mas[i] == other.data->get_mas()[i]);
-        }
-    } else if (!small && other.small) {
-        for (size_t i = 0; i < sz; i++) {
-            ok &= (data->get_mas()[i] == other.static_mas[i]);
-        }
-    } else if (!small && !other.small) {
-        for (size_t i = 0; i < sz; i++) {
-            ok &= (data->get_mas()[i] == other.data->get_mas()[i]);
-        }
+}
+
+void storage::detach() {
+    if (!is_small()) {
+        reallocate(data->capacity());
     }
-    return ok;
+}
+
+void storage::assign_word(uint64_t word, size_t count) {
+    assert(count <= 2);
+    delete_current_buffer();
+    meta = (meta & TAG_FLAG) | (count << SIZE_SHIFT);
+    static_mas[0] = static_cast<uint32_t>(word);
+    static_mas[1] = static_cast<uint32_t>(word >> 32u);
 }
 
 void storage::check_ref_counter() {
@@ -61,12 +94,8 @@ void storage::check_ref_counter() {
 }
 
 void storage::delete_current_buffer() {
-    if (!small) {
-        if (data->get_ref_counter() == 1) {
-            delete data;
-        } else {
-            data->dec_ref_counter();
-        }
+    if (!is_small() && data->dec_ref_counter() == 0) {
+        buffer::release(data);
     }
 }
 
@@ -75,107 +104,131 @@ storage& storage::operator=(storage const& other) {
         return *this;
     }
     delete_current_buffer();
-    if (other.small) {
-        std::copy(other.static_mas, other.static_mas + other.sz, static_mas);
+    if (other.is_small()) {
+        std::copy(other.static_mas, other.static_mas + other.size(), static_mas);
     } else {
         data = other.data;
         data->inc_ref_counter();
     }
-    small = other.small;
-    sz = other.sz;
+    meta = other.meta;
     return *this;
 }
 
-storage::storage(storage const& other) {
-    if (other.small) {
-        std::copy(other.static_mas, other.static_mas + other.sz, static_mas);
+storage::storage(storage const& other) : meta(other.meta) {
+    if (other.is_small()) {
+        std::copy(other.static_mas, other.static_mas + other.size(), static_mas);
     } else {
         data = other.data;
         data->inc_ref_counter();
     }
-    sz = other.sz;
-    small = other.small;
+}
+
+storage::storage(storage&& other) noexcept {
+    steal(other);
+}
+
+storage& storage::operator=(storage&& other) noexcept {
+    if (this != &other) {
+        delete_current_buffer();
+        steal(other);
+    }
+    return *this;
+}
+
+void storage::steal(storage& other) noexcept {
+    if (other.is_small()) {
+        std::copy(other.static_mas, other.static_mas + other.size(), static_mas);
+    } else {
+        data = other.data;
+    }
+    meta = other.meta;
+    other.meta = 0;
+}
+
+bool storage::is_shared() const {
+    return !is_small() && data->get_ref_counter() > 1;
 }
 
 void storage::reverse() {
-    if (small) {
-        std::reverse(static_mas, static_mas + sz);
+    if (is_small()) {
+        std::reverse(static_mas, static_mas + size());
     } else {
         check_ref_counter();
-        std::reverse(data->get_mas().begin(), data->get_mas().end());
+        std::reverse(data->data(), data->data() + size());
     }
 }
 
 const uint32_t& storage::operator[](size_t pos) const {
-    if (small) {
+    if (is_small()) {
         return static_mas[pos];
     } else {
-        return (data->get_mas())[pos];
+        return data->data()[pos];
     }
 }
 
-uint32_t& storage::operator[](size_t pos) {
-    if (small) {
-        return static_mas[pos];
-    } else {
+// the only way to get writable limbs: a shared buffer is copied here once,
+// before the first of `count` limbs is overwritten, and never on reads
+uint32_t* storage::prepare_write(size_t count) {
+    assert(count <= size());
+    if (is_small()) {
+        return static_mas;
+    }
+    if (count != 0) {
         check_ref_counter();
-        return (data->get_mas())[pos];
     }
+    return data->data();
 }
 
 void storage::erase(size_t l, size_t r) {
+    size_t sz = size();
     assert(l <= r && r < sz);
-    if (small) {
-        for (size_t i = l, j = r; i < sz && j < sz; i++, j++) {
-            static_mas[i] = static_mas[j];
-        }
-        sz = sz - (r - l);
+    if (is_small()) {
+        std::copy(static_mas + r, static_mas + sz, static_mas + l);
     } else {
         check_ref_counter();
-        data->get_mas().erase(data->get_mas().begin() + l, data->get_mas().begin() + r);
-        sz = data->get_mas().size();
+        std::copy(data->data() + r, data->data() + sz, data->data() + l);
     }
+    set_size(sz - (r - l));
 }
 
 uint32_t const& storage::back() const {
-    if (small) {
-        return static_mas[sz - 1];
-    } else {
-        return data->get_mas().back();
-    }
+    return limbs()[size() - 1];
 }
 
 void storage::push_back(uint32_t val) {
-    if (small && sz + 1 <= SMALL_SIZE) {
+    size_t sz = size();
+    if (is_small() && sz < SMALL_SIZE) {
         static_mas[sz] = val;
-        sz++;
-    } else if (small && sz == SMALL_SIZE) {
-        std::vector <uint32_t> cur_mas(static_mas, static_mas + SMALL_SIZE);
-        cur_mas.push_back(val);
-        data = new buffer(cur_mas);
-        sz++;
-        small = false;
+    } else if (is_small()) {
+        buffer *new_data = buffer::allocate(static_mas, SMALL_SIZE, 2 * SMALL_SIZE);
+        new_data->data()[sz] = val;
+        set_heap(new_data);
     } else {
-        check_ref_counter();
-        data->get_mas().push_back(val);
-        sz = data->get_mas().size();
+        make_unique(sz + 1);
+        data->data()[sz] = val;
     }
+    set_size(sz + 1);
 }
 
+// the size is kept in the header word for both layouts, so it never costs a
+// load through the buffer pointer
 size_t storage::size() const {
-    if (small) {
-        return sz;
-    } else {
-        return data->get_mas().size();
-    }
+    return meta >> SIZE_SHIFT;
+}
+
+size_t storage::capacity() const {
+    return (is_small() ? SMALL_SIZE : data->capacity());
 }
 
-uint32_t& storage::back() {
-    if (small) {
-        return static_mas[sz - 1];
+void storage::reserve(size_t nw_capacity) {
+    if (is_small()) {
+        if (nw_capacity > SMALL_SIZE) {
+            set_heap(buffer::allocate(static_mas, size(), nw_capacity));
+        }
+    } else if (nw_capacity > data->capacity()) {
+        reallocate(nw_capacity);
     } else {
         check_ref_counter();
-        return data->get_mas().back();
     }
 }
 
@@ -184,23 +237,24 @@ void storage::resize(size_t nw_size) {
 }
 
 void storage::resize(size_t nw_size, uint32_t val) {
-    if (small) {
-        if (nw_size > sz && nw_size > SMALL_SIZE) {
-            std::vector<uint32_t> vec(nw_size);
-            std::copy(static_mas, static_mas + sz, vec.begin());
-            std::fill(vec.begin() + sz, vec.begin() + nw_size, val);
-            data = new buffer(vec);
-            sz = nw_size;
-            small = false;
-        } else if (nw_size > sz && nw_size <= SMALL_SIZE) {
+    size_t sz = size();
+    if (nw_size <= sz) {
+        // dropping limbs never writes to them, so a shared buffer stays
+        // shared and only this owner's size changes
+        set_size(nw_size);
+        return;
+    }
+    if (is_small()) {
+        if (nw_size > SMALL_SIZE) {
+            buffer *new_data = buffer::allocate(static_mas, sz, nw_size);
+            std::fill(new_data->data() + sz, new_data->data() + nw_size, val);
+            set_heap(new_data);
+        } else {
             std::fill(static_mas + sz, static_mas + nw_size, val);
-            sz = nw_size;
-        } else if (nw_size <= sz) {
-            sz = nw_size;
         }
     } else {
-        check_ref_counter();
-        sz = nw_size;
-        data->get_mas().resize(nw_size, val);
+        make_unique(nw_size);
+        std::fill(data->data() + sz, data->data() + nw_size, val);
     }
+    set_size(nw_size);
 }
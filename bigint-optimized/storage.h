@@ -12,36 +12,62 @@
 #include <vector>
 #include <iterator>
 
+#ifndef BIGINT_INLINE_LIMBS
+#define BIGINT_INLINE_LIMBS 6
+#endif
+
 struct storage {
     storage();
 
     storage(storage const& other);
+    storage(storage&& other) noexcept;
 
     storage& operator=(storage const& other);
+    storage& operator=(storage&& other) noexcept;
 
     ~storage();
 
     void push_back(uint32_t val);
     size_t size() const;
-    uint32_t& back();
+    size_t capacity() const;
+    void reserve(size_t nw_capacity);
     void resize(size_t nw_size, uint32_t val);
     void resize(size_t nw_size);
     void reverse();
     const uint32_t& operator[](size_t pos) const;
-    uint32_t& operator[](size_t pos);
+    uint32_t const* limbs() const;
+    uint32_t* prepare_write(size_t count);
 
     uint32_t const& back() const;
     void erase(size_t l, size_t r);
     bool operator==(storage const& other) const ;
     std::vector<uint32_t> get_mas_copy() const;
-    static const size_t SMALL_SIZE = 8;
+    bool is_shared() const;
+    void make_persistent();
+    void detach();
+    void assign_word(uint64_t word, size_t count);
+    bool tag() const;
+    void set_tag(bool value);
+    static const size_t SMALL_SIZE = BIGINT_INLINE_LIMBS;
+    static_assert(SMALL_SIZE >= 2, "inline storage must hold at least two limbs");
 private:
     void unshare();
     void delete_current_buffer();
     void check_ref_counter();
+    void reallocate(size_t nw_capacity);
+    void make_unique(size_t min_capacity);
+    void steal(storage& other) noexcept;
+    bool is_small() const;
+    void set_heap(buffer* new_data);
+    void set_size(size_t nw_size);
 private:
-    size_t sz;
-    bool small;
+    // one word for the size, the heap flag and a spare tag bit the owner may
+    // use (big_integer keeps its sign there), so a number is 8 bytes of header
+    // plus whichever of the pointer or the inline limbs is in use
+    static const size_t HEAP_FLAG = 1;
+    static const size_t TAG_FLAG = 2;
+    static const size_t SIZE_SHIFT = 2;
+    size_t meta;
     union {
         buffer* data;
         uint32_t static_mas[SMALL_SIZE];